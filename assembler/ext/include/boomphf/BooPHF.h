@@ -584,6 +584,14 @@ class bitVector {
         return _bitArray[cell64];
     }
 
+    // bring the word of bit pos and its rank sample into cache
+    void prefetch(uint64_t pos) const {
+        __builtin_prefetch(_bitArray + (pos >> 6));
+        uint64_t block = pos / _nb_bits_per_rank_sample;
+        if (block < _ranks.size())
+            __builtin_prefetch(_ranks.data() + block);
+    }
+
     //set bit pos to 1
     void set(uint64_t pos) {
         assert(pos<_size);
@@ -686,6 +694,10 @@ class level{
         return bitset.get(hashi);
     }
 
+    void prefetch(uint64_t hash_raw) const {
+        bitset.prefetch(fastrange64(hash_raw, hash_domain));
+    }
+
     uint64_t idx_begin;
     uint64_t hash_domain;
     bitVector bitset;
@@ -838,6 +850,16 @@ class mphf {
         return minimal_hp;
     }
 
+    // hint the cache about the first level words lookup(elem) is going to touch,
+    // most of the keys are resolved there
+    template<class elem_t>
+    void prefetch(const elem_t &elem) const {
+        if (!_built || _nb_levels < 2)
+            return;
+
+        _levels[0].prefetch(_hasher.hashpair128(elem)[0]);
+    }
+
     uint64_t size() const {
         return _nelem;
     }
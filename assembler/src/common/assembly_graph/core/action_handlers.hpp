@@ -126,6 +126,16 @@ public:
         return false;
     }
 
+    /**
+     * Deferrable handlers receive events of an event batch (see ObservableGraph::BeginEventBatch) only
+     * when the batch is committed, in original order, possibly concurrently with other deferrable handlers.
+     * Handler should override this method only if it maintains its own data, which is not queried
+     * during graph modifications, and does not depend on the state of other handlers.
+     */
+    virtual bool IsDeferrable() const {
+        return false;
+    }
+
     bool IsAttached() const {
         return attached_;
     }
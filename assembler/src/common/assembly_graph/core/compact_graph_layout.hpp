@@ -0,0 +1,182 @@
+//***************************************************************************
+//* Copyright (c) 2019 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include "action_handlers.hpp"
+#include "adt/iterator_range.hpp"
+#include "utils/parallel/openmp_wrapper.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace omnigraph {
+
+/**
+ * Structure-of-arrays snapshot of the graph topology for read-mostly phases.
+ * Adjacency is stored CSR-like (offsets + contiguous edge arrays), while end,
+ * start, conjugate, length and coverage of edges are kept in separate arrays
+ * indexed by the dense integer ids of the graph.
+ * Graph modifications only mark the layout as stale, it is rebuilt lazily by
+ * the next Refresh(). Coverage is the one of the last rebuild, since coverage
+ * changes are not reported to the handlers.
+ */
+template<class Graph>
+class CompactGraphLayout : public GraphActionHandler<Graph> {
+public:
+    typedef typename Graph::VertexId VertexId;
+    typedef typename Graph::EdgeId EdgeId;
+    typedef const EdgeId *edge_const_iterator;
+
+private:
+    typedef uint32_t offset_t;
+
+    std::vector<offset_t> out_offsets_;
+    std::vector<EdgeId> out_edges_;
+    std::vector<offset_t> in_offsets_;
+    std::vector<EdgeId> in_edges_;
+
+    std::vector<VertexId> vertex_conjugate_;
+
+    std::vector<VertexId> end_;
+    std::vector<VertexId> start_;
+    std::vector<EdgeId> conjugate_;
+    std::vector<uint32_t> length_;
+    std::vector<float> coverage_;
+
+    std::atomic<bool> stale_;
+    std::mutex rebuild_lock_;
+
+    void FillAdjacency(std::vector<offset_t> &offsets, std::vector<EdgeId> &edges,
+                       const std::vector<VertexId> &vertices, bool outgoing) {
+        offsets.assign(vertex_conjugate_.size() + 1, 0);
+        for (VertexId v : vertices)
+            offsets[v.int_id() + 1] = offset_t(outgoing ? this->g().OutgoingEdgeCount(v) :
+                                                          this->g().IncomingEdgeCount(v));
+        for (size_t i = 1; i < offsets.size(); ++i)
+            offsets[i] += offsets[i - 1];
+
+        edges.resize(offsets.back());
+#       pragma omp parallel for schedule(guided)
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            VertexId v = vertices[i];
+            EdgeId *dst = edges.data() + offsets[v.int_id()];
+            if (outgoing) {
+                for (EdgeId e : this->g().OutgoingEdges(v))
+                    *dst++ = e;
+            } else {
+                for (EdgeId e : this->g().IncomingEdges(v))
+                    *dst++ = e;
+            }
+        }
+    }
+
+    void Rebuild() {
+        const Graph &g = this->g();
+
+        std::vector<VertexId> vertices(g.begin(), g.end());
+        std::vector<EdgeId> edges;
+        edges.reserve(g.e_size());
+        for (EdgeId e : g.edges())
+            edges.push_back(e);
+
+        uint64_t max_vid = 0, max_eid = 0;
+        for (VertexId v : vertices)
+            max_vid = std::max(max_vid, v.int_id());
+        for (EdgeId e : edges)
+            max_eid = std::max(max_eid, e.int_id());
+
+        vertex_conjugate_.assign(max_vid + 1, VertexId());
+        for (VertexId v : vertices)
+            vertex_conjugate_[v.int_id()] = g.conjugate(v);
+
+        FillAdjacency(out_offsets_, out_edges_, vertices, true);
+        FillAdjacency(in_offsets_, in_edges_, vertices, false);
+
+        end_.assign(max_eid + 1, VertexId());
+        start_.assign(max_eid + 1, VertexId());
+        conjugate_.assign(max_eid + 1, EdgeId());
+        length_.assign(max_eid + 1, 0);
+        coverage_.assign(max_eid + 1, 0);
+#       pragma omp parallel for schedule(guided)
+        for (size_t i = 0; i < edges.size(); ++i) {
+            EdgeId e = edges[i];
+            size_t id = e.int_id();
+            end_[id] = g.EdgeEnd(e);
+            start_[id] = g.EdgeStart(e);
+            conjugate_[id] = g.conjugate(e);
+            length_[id] = uint32_t(g.length(e));
+            coverage_[id] = float(g.coverage(e));
+        }
+
+        TRACE("Compact layout rebuilt, " << vertices.size() << " vertices, " << edges.size() << " edges");
+    }
+
+    void MarkStale() {
+        stale_.store(true, std::memory_order_relaxed);
+    }
+
+public:
+    CompactGraphLayout(const Graph &g)
+            : GraphActionHandler<Graph>(g, "CompactGraphLayout"),
+              stale_(true) {}
+
+    /**
+     * Rebuilds the layout if the graph was modified since the last rebuild.
+     * Must not run concurrently with graph modifications or layout queries.
+     * @param force rebuild anyway, e.g. to pick up changed coverage
+     */
+    void Refresh(bool force = false) {
+        std::lock_guard<std::mutex> guard(rebuild_lock_);
+        if (!force && !stale_.load(std::memory_order_relaxed))
+            return;
+
+        Rebuild();
+        stale_.store(false, std::memory_order_relaxed);
+    }
+
+    bool stale() const {
+        return stale_.load(std::memory_order_relaxed);
+    }
+
+    size_t OutgoingEdgeCount(VertexId v) const {
+        return out_offsets_[v.int_id() + 1] - out_offsets_[v.int_id()];
+    }
+
+    size_t IncomingEdgeCount(VertexId v) const {
+        return in_offsets_[v.int_id() + 1] - in_offsets_[v.int_id()];
+    }
+
+    adt::iterator_range<edge_const_iterator> OutgoingEdges(VertexId v) const {
+        return { out_edges_.data() + out_offsets_[v.int_id()],
+                 out_edges_.data() + out_offsets_[v.int_id() + 1] };
+    }
+
+    adt::iterator_range<edge_const_iterator> IncomingEdges(VertexId v) const {
+        return { in_edges_.data() + in_offsets_[v.int_id()],
+                 in_edges_.data() + in_offsets_[v.int_id() + 1] };
+    }
+
+    VertexId conjugate(VertexId v) const { return vertex_conjugate_[v.int_id()]; }
+    EdgeId conjugate(EdgeId e) const { return conjugate_[e.int_id()]; }
+    VertexId EdgeEnd(EdgeId e) const { return end_[e.int_id()]; }
+    VertexId EdgeStart(EdgeId e) const { return start_[e.int_id()]; }
+    size_t length(EdgeId e) const { return length_[e.int_id()]; }
+    double coverage(EdgeId e) const { return coverage_[e.int_id()]; }
+
+    void HandleAdd(VertexId) override { MarkStale(); }
+    void HandleAdd(EdgeId) override { MarkStale(); }
+    void HandleDelete(VertexId) override { MarkStale(); }
+    void HandleDelete(EdgeId) override { MarkStale(); }
+
+    bool IsThreadSafe() const override { return true; }
+
+private:
+    DECL_LOGGER("CompactGraphLayout");
+};
+
+}
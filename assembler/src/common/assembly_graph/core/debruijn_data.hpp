@@ -9,7 +9,9 @@
 #include "utils/verify.hpp"
 #include "utils/logger/logger.hpp"
 #include "sequence/sequence_tools.hpp"
+#include "sequence/nucl_arena.hpp"
 
+#include <memory>
 #include <vector>
 #include <set>
 #include <cstring>
@@ -53,15 +55,40 @@ class DeBruijnEdgeData {
     friend class DeBruijnDataMaster;
     CoverageData coverage_;
     CoverageData flanking_cov_;
+    // Owned nucleotides, empty if they reside in the arena of the data master
     Sequence nucls_;
+    // Nucleotides of the edge, either of nucls_ or in the arena
+    SequenceView view_;
+    bool in_arena_;
+
+    static const Sequence &NoNucls() {
+        static const Sequence empty;
+        return empty;
+    }
+
+    explicit DeBruijnEdgeData(const SequenceView &arena_nucls) :
+            nucls_(NoNucls()), view_(arena_nucls), in_arena_(true) {
+    }
+
+    void set_arena_nucls(const SequenceView &arena_nucls) {
+        nucls_ = NoNucls();
+        view_ = arena_nucls;
+        in_arena_ = true;
+    }
+
 public:
 
     explicit DeBruijnEdgeData(const Sequence &nucls) :
-            nucls_(nucls) {
+            nucls_(nucls), view_(nucls_.view()), in_arena_(false) {
+    }
+
+    // Nucleotides residing in the arena are copied
+    Sequence nucls() const {
+        return in_arena_ ? Sequence(view_) : nucls_;
     }
 
-    const Sequence& nucls() const {
-        return nucls_;
+    SequenceView nucls_view() const {
+        return view_;
     }
 
     void inc_raw_coverage(int value) {
@@ -90,13 +117,15 @@ public:
     }
 
     size_t size() const {
-        return nucls_.size();
+        return view_.size();
     }
 };
 
 class DeBruijnDataMaster {
 private:
     const size_t k_;
+    // Optional storage of the edge nucleotides, shared by the copies of the master
+    std::shared_ptr<NuclArena> arena_;
 
 public:
     typedef DeBruijnVertexData VertexData;
@@ -113,11 +142,13 @@ public:
     EdgeData GlueData(const EdgeData&, const EdgeData& data2) const;
 
     bool isSelfConjugate(const EdgeData &data) const {
-        return data.nucls() == !(data.nucls());
+        return data.nucls_view() == !(data.nucls_view());
     }
 
     EdgeData conjugate(const EdgeData &data) const {
-        return EdgeData(!(data.nucls()));
+        if (data.in_arena_)
+            return EdgeData(!data.view_);
+        return EdgeData(!data.nucls_);
     }
 
     VertexData conjugate(const VertexData & /*data*/) const {
@@ -125,7 +156,7 @@ public:
     }
 
     size_t length(const EdgeData& data) const {
-        return data.nucls().size() - k_;
+        return data.size() - k_;
     }
 
     size_t length(const VertexData& ) const {
@@ -136,6 +167,30 @@ public:
         return k_;
     }
 
+    const std::shared_ptr<NuclArena> &arena() const {
+        return arena_;
+    }
+
+    void set_arena(std::shared_ptr<NuclArena> arena) {
+        arena_ = std::move(arena);
+    }
+
+    EdgeData PlaceData(const EdgeData &data) const {
+        if (!arena_ || data.in_arena_)
+            return data;
+
+        EdgeData res(data);
+        res.set_arena_nucls(arena_->Place(data.view_));
+        return res;
+    }
+
+    // Copies nucleotides of the edge into the arena, conjugate edge shares them
+    void PlaceNucls(EdgeData &data, EdgeData &conj_data) const {
+        VERIFY(arena_);
+        data.set_arena_nucls(arena_->Place(data.view_));
+        if (&conj_data != &data)
+            conj_data.set_arena_nucls(!data.view_);
+    }
 };
 
 //typedef DeBruijnVertexData VertexData;
@@ -154,13 +209,13 @@ inline const DeBruijnEdgeData DeBruijnDataMaster::MergeData(const std::vector<co
 inline std::pair<DeBruijnVertexData, std::pair<DeBruijnEdgeData, DeBruijnEdgeData>> DeBruijnDataMaster::SplitData(const EdgeData& edge,
                                                                                                                   size_t position, 
                                                                                                                   bool is_self_conj) const {
-    const Sequence& nucls = edge.nucls();
+    Sequence nucls = edge.nucls();
     size_t end = nucls.size();
     if (is_self_conj) {
         VERIFY(position < end);
         end -= position;
     }
-    return std::make_pair(VertexData(), std::make_pair(EdgeData(edge.nucls().Subseq(0, position + k_)), EdgeData(nucls.Subseq(position, end))));
+    return std::make_pair(VertexData(), std::make_pair(EdgeData(nucls.Subseq(0, position + k_)), EdgeData(nucls.Subseq(position, end))));
 }
 
 inline DeBruijnEdgeData DeBruijnDataMaster::GlueData(const DeBruijnEdgeData&, const DeBruijnEdgeData& data2) const {
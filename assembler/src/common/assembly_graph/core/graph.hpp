@@ -70,12 +70,47 @@ public:
     }
 
     /**
-     * Method returns Sequence stored in the edge
+     * Method returns Sequence stored in the edge, sequences residing in the
+     * arena are copied (see EdgeNuclsView)
      */
-    const Sequence& EdgeNucls(EdgeId edge) const {
+    Sequence EdgeNucls(EdgeId edge) const {
         return this->data(edge).nucls();
     }
 
+    /**
+     * Non-owning view of the edge nucleotides, valid until the edge is
+     * removed or the sequences are compacted
+     */
+    SequenceView EdgeNuclsView(EdgeId edge) const {
+        return this->data(edge).nucls_view();
+    }
+
+    /**
+     * Edge sequences added afterwards are allocated in the graph-wide arena
+     */
+    void EnableNuclArena() {
+        if (!master().arena())
+            mutable_master().set_arena(std::make_shared<NuclArena>());
+    }
+
+    /**
+     * Moves all the edge sequences into fresh arena slabs, so the space of
+     * the removed edges is released. No-op if the arena is not enabled.
+     */
+    void CompactNucls() {
+        const auto &arena = master().arena();
+        if (!arena)
+            return;
+
+        arena->Reset();
+        std::vector<EdgeId> edges(this->canonical_edges().begin(), this->canonical_edges().end());
+#       pragma omp parallel for schedule(guided)
+        for (size_t i = 0; i < edges.size(); ++i)
+            master().PlaceNucls(this->data(edges[i]), this->data(this->conjugate(edges[i])));
+        arena->ReleaseRetired();
+        INFO("Edge sequences compacted, " << arena->placed() << " nucleotides in the arena");
+    }
+
     const Sequence VertexNucls(VertexId v) const {
         //todo add verify on vertex nucls consistency
         if (this->OutgoingEdgeCount(v) > 0) {
@@ -282,16 +282,22 @@ private:
         }
 
         void erase(uint64_t id) {
-            auto *v = storage_[id];
-
-            // INFO("Remove " << id << ":" << cid);
-            delete v;
+            destroy(id);
+            size_ -= 1;
+        }
 
-            id_distributor_.release(id);
-            storage_[id] = nullptr;
+        // Element is not counted anymore, but is kept alive (and its id occupied) until purge()
+        void retire(uint64_t id) {
+            retired_.push_back(id);
             size_ -= 1;
         }
 
+        void purge() {
+            for (uint64_t id : retired_)
+                destroy(id);
+            retired_.clear();
+        }
+
         T* at(uint64_t id) const {
             return storage_[id];
         }
@@ -300,9 +306,20 @@ private:
         void clear_state() { id_distributor_.clear_state(); }
 
       private:
+        void destroy(uint64_t id) {
+            auto *v = storage_[id];
+
+            // INFO("Remove " << id << ":" << cid);
+            delete v;
+
+            id_distributor_.release(id);
+            storage_[id] = nullptr;
+        }
+
         std::atomic<size_t> size_;
         uint64_t bias_;
         std::vector<T*> storage_;
+        std::vector<uint64_t> retired_;
         omnigraph::ReclaimingIdDistributor id_distributor_;
     };
 
@@ -310,6 +327,7 @@ private:
     VertexStorage vstorage_;
     using EdgeStorage = IdStorage<PairedEdge<DataMaster>>;
     EdgeStorage estorage_;
+    bool defer_destruction_ = false;
 
     PairedVertex<DataMaster>* vertex(VertexId id) const {
         return vstorage_.at(id.int_id());
@@ -461,6 +479,11 @@ private:
 
     void DestroyVertex(VertexId v) {
         VertexId cv = conjugate(v);
+        if (defer_destruction_) {
+            vstorage_.retire(v.int_id());
+            vstorage_.retire(cv.int_id());
+            return;
+        }
         vstorage_.erase(v.int_id());
         vstorage_.erase(cv.int_id());
     }
@@ -476,6 +499,12 @@ private:
     }
 
     void DestroyEdge(EdgeId e, EdgeId rc) {
+        if (defer_destruction_) {
+            if (e != rc)
+                estorage_.retire(rc.int_id());
+            estorage_.retire(e.int_id());
+            return;
+        }
         if (e != rc)
             estorage_.erase(rc.int_id());
         estorage_.erase(e.int_id());
@@ -495,8 +524,9 @@ protected:
         DestroyVertex(vertex);
     }
 
-    EdgeId HiddenAddEdge(const EdgeData& data,
+    EdgeId HiddenAddEdge(const EdgeData& raw_data,
                          EdgeId at1 = 0, EdgeId at2 = 0) {
+        EdgeData data = master_.PlaceData(raw_data);
         EdgeId result = AddSingleEdge(VertexId(), VertexId(), data, at1);
         if (this->master().isSelfConjugate(data)) {
             edge(result)->set_conjugate(result);
@@ -512,8 +542,9 @@ protected:
         return result;
     }
 
-    EdgeId HiddenAddEdge(VertexId v1, VertexId v2, const EdgeData& data,
+    EdgeId HiddenAddEdge(VertexId v1, VertexId v2, const EdgeData& raw_data,
                          EdgeId at1 = 0, EdgeId at2 = 0) {
+        EdgeData data = master_.PlaceData(raw_data);
         //      todo was suppressed for concurrent execution reasons (see concurrent_graph_component.hpp)
         //      VERIFY(this->vertices_.find(v1) != this->vertices_.end() && this->vertices_.find(v2) != this->vertices_.end());
         EdgeId result = AddSingleEdge(v1, v2, data, at1);
@@ -553,6 +584,21 @@ protected:
             HiddenDeleteVertex(v);
     }
 
+    /**
+     * Deleted vertices and edges are unlinked from the graph and stop being counted in size() / e_size()
+     * as usual, but their data and ids are kept until DestroyDeferred() is called.
+     * Until then they are still reported by contains() and whole-graph iteration.
+     */
+    void DeferDestruction() {
+        defer_destruction_ = true;
+    }
+
+    void DestroyDeferred() {
+        defer_destruction_ = false;
+        estorage_.purge();
+        vstorage_.purge();
+    }
+
 public:
     GraphCore(const DataMaster& master)
             : master_(master),
@@ -584,6 +630,7 @@ public:
     size_t int_id(VertexId vertex) const { return vertex.int_id(); }
 
     const DataMaster& master() const { return master_; }
+    DataMaster& mutable_master() { return master_; }
     const EdgeData& data(EdgeId e) const { return edge(e)->data(); }
     const VertexData& data(VertexId v) const { return vertex(v)->data(); }
     EdgeData& data(EdgeId e) { return edge(e)->data(); }
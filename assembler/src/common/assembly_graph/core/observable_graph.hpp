@@ -8,9 +8,11 @@
 #pragma once
 
 #include "utils/logger/logger.hpp"
+#include "utils/parallel/openmp_wrapper.h"
 #include "graph_core.hpp"
 #include "graph_iterators.hpp"
 
+#include <algorithm>
 #include <vector>
 #include <set>
 #include <cstring>
@@ -36,10 +38,35 @@ public:
     typedef ActionHandler<VertexId, EdgeId> Handler;
 
 private:
+    struct Event {
+        enum class Kind { AddVertex, AddEdge, DeleteVertex, DeleteEdge, Merge, Glue, Split };
+
+        Kind kind;
+        VertexId v;
+        EdgeId e1, e2, e3;
+        size_t path;
+    };
+
    //todo switch to smart iterators
    mutable std::vector<Handler*> action_handler_list_;
    std::unique_ptr<const HandlerApplier<VertexId, EdgeId>> applier_;
 
+   bool batch_open_ = false;
+   mutable std::vector<Event> event_log_;
+   mutable std::vector<std::vector<EdgeId>> merged_paths_;
+
+   bool NotifyNow(const Handler &handler) const {
+       return handler.IsAttached() && !(batch_open_ && handler.IsDeferrable());
+   }
+
+   void LogEvent(typename Event::Kind kind, VertexId v, EdgeId e1 = EdgeId(), EdgeId e2 = EdgeId(),
+                 EdgeId e3 = EdgeId(), size_t path = 0) const {
+       if (batch_open_)
+           event_log_.push_back({kind, v, e1, e2, e3, path});
+   }
+
+   void Dispatch(Handler &handler, const Event &event) const;
+
 public:
 //todo move to graph core
     typedef ConstructionHelper<DataMaster> HelperT;
@@ -82,6 +109,28 @@ public:
 
     bool VerifyAllDetached();
 
+    /**
+     * Starts an event batch, batches can not be nested. Until the batch is committed, events are logged
+     * instead of being passed to deferrable handlers (see ActionHandler::IsDeferrable), while other handlers
+     * are notified immediately as usual. Deleted elements are unlinked at once, but kept alive for
+     * deferrable handlers till the commit, see GraphCore::DeferDestruction.
+     * Handlers should not be attached or detached while the batch is open.
+     */
+    void BeginEventBatch();
+
+    /**
+     * Commits the event batch: every attached deferrable handler consumes the whole log, different
+     * handlers run in parallel. Elements deleted within the batch are destroyed afterwards.
+     */
+    void CommitEventBatch();
+
+    /**
+     * Number of events logged in the open event batch.
+     */
+    size_t PendingEventCount() const {
+        return event_log_.size();
+    }
+
     //smart iterators
     template<typename Comparator>
     SmartVertexIterator<ObservableGraph, Comparator> SmartVertexBegin(
@@ -151,6 +200,12 @@ public:
 
     EdgeId MergePath(const std::vector<EdgeId> &path, bool safe_merging = true);
 
+    /**
+     * Merges the path already passed through CorrectMergePath, the new edge gets precomputed merged data.
+     * Allows merged data to be built beforehand, e.g. in parallel.
+     */
+    EdgeId MergeCorrectedPath(const std::vector<EdgeId> &corrected_path, const EdgeData &merged_data);
+
     std::pair<EdgeId, EdgeId> SplitEdge(EdgeId edge, size_t position);
 
     EdgeId GlueEdges(EdgeId edge1, EdgeId edge2);
@@ -159,6 +214,33 @@ private:
     DECL_LOGGER("ObservableGraph")
 };
 
+/**
+ * Scoped event batch, see ObservableGraph::BeginEventBatch.
+ */
+template<class Graph>
+class EventBatch : private boost::noncopyable {
+    Graph &g_;
+
+public:
+    EventBatch(Graph &g) : g_(g) {
+        g_.BeginEventBatch();
+    }
+
+    ~EventBatch() {
+        g_.CommitEventBatch();
+    }
+
+    /**
+     * Commits the events logged so far and starts a new batch if there are at least max_events of them.
+     */
+    void CommitIfExceeds(size_t max_events) {
+        if (g_.PendingEventCount() < max_events)
+            return;
+        g_.CommitEventBatch();
+        g_.BeginEventBatch();
+    }
+};
+
 template<class DataMaster>
 typename ObservableGraph<DataMaster>::VertexId
 ObservableGraph<DataMaster>::AddVertex(const VertexData &data, VertexId id1, VertexId id2) {
@@ -325,66 +407,134 @@ void ObservableGraph<DataMaster>::FireGameOver() const {
 template<class DataMaster>
 void ObservableGraph<DataMaster>::FireAddVertex(VertexId v) const {
     for (Handler* handler_ptr : action_handler_list_) {
-        if (handler_ptr->IsAttached()) {
+        if (NotifyNow(*handler_ptr)) {
             TRACE("FireAddVertex to handler " << handler_ptr->name());
             applier_->ApplyAdd(*handler_ptr, v);
         }
     }
+    LogEvent(Event::Kind::AddVertex, v);
 }
 
 template<class DataMaster>
 void ObservableGraph<DataMaster>::FireAddEdge(EdgeId e) const {
     for (Handler* handler_ptr : action_handler_list_) {
-        if (handler_ptr->IsAttached()) {
+        if (NotifyNow(*handler_ptr)) {
             TRACE("FireAddEdge to handler " << handler_ptr->name());
             applier_->ApplyAdd(*handler_ptr, e);
         }
     }
+    LogEvent(Event::Kind::AddEdge, VertexId(), e);
 }
 
 template<class DataMaster>
 void ObservableGraph<DataMaster>::FireDeleteVertex(VertexId v) const {
     for (auto it = action_handler_list_.rbegin(); it != action_handler_list_.rend(); ++it) {
-        if ((*it)->IsAttached()) {
+        if (NotifyNow(**it)) {
             applier_->ApplyDelete(**it, v);
         }
     }
+    LogEvent(Event::Kind::DeleteVertex, v);
 }
 
 template<class DataMaster>
 void ObservableGraph<DataMaster>::FireDeleteEdge(EdgeId e) const {
     for (auto it = action_handler_list_.rbegin(); it != action_handler_list_.rend(); ++it) {
-        if ((*it)->IsAttached()) {
+        if (NotifyNow(**it)) {
             applier_->ApplyDelete(**it, e);
         }
     };
+    LogEvent(Event::Kind::DeleteEdge, VertexId(), e);
 }
 
 template<class DataMaster>
 void ObservableGraph<DataMaster>::FireMerge(const std::vector<EdgeId> &old_edges, EdgeId new_edge) const {
     for (Handler* handler_ptr : action_handler_list_) {
-        if (handler_ptr->IsAttached()) {
+        if (NotifyNow(*handler_ptr)) {
             applier_->ApplyMerge(*handler_ptr, old_edges, new_edge);
         }
     }
+    if (batch_open_) {
+        merged_paths_.push_back(old_edges);
+        LogEvent(Event::Kind::Merge, VertexId(), new_edge, EdgeId(), EdgeId(), merged_paths_.size() - 1);
+    }
 }
 
 template<class DataMaster>
 void ObservableGraph<DataMaster>::FireGlue(EdgeId new_edge, EdgeId edge1, EdgeId edge2) const {
     for (Handler* handler_ptr : action_handler_list_) {
-        if (handler_ptr->IsAttached()) {
+        if (NotifyNow(*handler_ptr)) {
             applier_->ApplyGlue(*handler_ptr, new_edge, edge1, edge2);
         }
     };
+    LogEvent(Event::Kind::Glue, VertexId(), new_edge, edge1, edge2);
 }
 
 template<class DataMaster>
 void ObservableGraph<DataMaster>::FireSplit(EdgeId edge, EdgeId new_edge1, EdgeId new_edge2) const {
     for (Handler* handler_ptr : action_handler_list_) {
-        if (handler_ptr->IsAttached()) {
+        if (NotifyNow(*handler_ptr)) {
             applier_->ApplySplit(*handler_ptr, edge, new_edge1, new_edge2);
         }
     }
+    LogEvent(Event::Kind::Split, VertexId(), edge, new_edge1, new_edge2);
+}
+
+template<class DataMaster>
+void ObservableGraph<DataMaster>::Dispatch(Handler &handler, const Event &event) const {
+    switch (event.kind) {
+        case Event::Kind::AddVertex:
+            applier_->ApplyAdd(handler, event.v);
+            break;
+        case Event::Kind::AddEdge:
+            applier_->ApplyAdd(handler, event.e1);
+            break;
+        case Event::Kind::DeleteVertex:
+            applier_->ApplyDelete(handler, event.v);
+            break;
+        case Event::Kind::DeleteEdge:
+            applier_->ApplyDelete(handler, event.e1);
+            break;
+        case Event::Kind::Merge:
+            applier_->ApplyMerge(handler, merged_paths_[event.path], event.e1);
+            break;
+        case Event::Kind::Glue:
+            applier_->ApplyGlue(handler, event.e1, event.e2, event.e3);
+            break;
+        case Event::Kind::Split:
+            applier_->ApplySplit(handler, event.e1, event.e2, event.e3);
+            break;
+    }
+}
+
+template<class DataMaster>
+void ObservableGraph<DataMaster>::BeginEventBatch() {
+    VERIFY_MSG(!batch_open_, "Nested event batches are not supported");
+    VERIFY(event_log_.empty());
+    batch_open_ = true;
+    base::DeferDestruction();
+}
+
+template<class DataMaster>
+void ObservableGraph<DataMaster>::CommitEventBatch() {
+    VERIFY(batch_open_);
+    batch_open_ = false;
+
+    std::vector<Handler*> deferred;
+    for (Handler* handler_ptr : action_handler_list_) {
+        if (handler_ptr->IsAttached() && handler_ptr->IsDeferrable())
+            deferred.push_back(handler_ptr);
+    }
+    TRACE("Committing " << event_log_.size() << " events to " << deferred.size() << " handlers");
+
+#   pragma omp parallel for schedule(dynamic, 1)
+    for (size_t i = 0; i < deferred.size(); ++i) {
+        for (const Event &event : event_log_)
+            Dispatch(*deferred[i], event);
+    }
+
+    event_log_.clear();
+    merged_paths_.clear();
+    base::DestroyDeferred();
 }
 
 template<class DataMaster>
@@ -445,10 +595,11 @@ template<class DataMaster>
 typename ObservableGraph<DataMaster>::EdgeId
         ObservableGraph<DataMaster>::MergePath(const std::vector<EdgeId>& path, bool safe_merging) {
     VERIFY(!path.empty());
-    for (size_t i = 0; i < path.size(); i++)
-        for (size_t j = i + 1; j < path.size(); j++) {
-            VERIFY(path[i] != path[j]);
-        }
+    {
+        std::vector<EdgeId> sorted_path(path);
+        std::sort(sorted_path.begin(), sorted_path.end());
+        VERIFY(std::adjacent_find(sorted_path.begin(), sorted_path.end()) == sorted_path.end());
+    }
     if (path.size() == 1) {
         TRACE(
                 "Path of single edge " << base::str(*(path.begin())) << ". Nothing to merge.");
@@ -456,13 +607,21 @@ typename ObservableGraph<DataMaster>::EdgeId
     //      cerr << "Merging " << PrintDetailedPath(pObservableGraph<DataMaster><VertexIdT, EdgeIdT, VertexIt>ath) << endl;
     //      cerr << "Conjugate " << PrintConjugatePath(path) << endl;
     auto corrected_path = CorrectMergePath(path);
-    VertexId v1 = base::EdgeStart(corrected_path[0]);
-    VertexId v2 = base::EdgeEnd(corrected_path[corrected_path.size() - 1]);
     std::vector<const EdgeData *> to_merge;
     for (auto it = corrected_path.begin(); it != corrected_path.end(); ++it) {
         to_merge.push_back(&(base::data(*it)));
     }
-    EdgeId new_edge = base::HiddenAddEdge(v1, v2, base::master().MergeData(to_merge, safe_merging));
+    return MergeCorrectedPath(corrected_path, base::master().MergeData(to_merge, safe_merging));
+}
+
+template<class DataMaster>
+typename ObservableGraph<DataMaster>::EdgeId
+        ObservableGraph<DataMaster>::MergeCorrectedPath(const std::vector<EdgeId>& corrected_path,
+                                                        const EdgeData &merged_data) {
+    VERIFY(!corrected_path.empty());
+    VertexId v1 = base::EdgeStart(corrected_path[0]);
+    VertexId v2 = base::EdgeEnd(corrected_path[corrected_path.size() - 1]);
+    EdgeId new_edge = base::HiddenAddEdge(v1, v2, merged_data);
     FireMerge(corrected_path, new_edge);
     auto edges_to_delete = EdgesToDelete(corrected_path);
     auto vertices_to_delete = VerticesToDelete(corrected_path);
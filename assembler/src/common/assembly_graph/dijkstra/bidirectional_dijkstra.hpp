@@ -0,0 +1,273 @@
+//***************************************************************************
+//* Copyright (c) 2019 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include "utils/verify.hpp"
+#include "utils/logger/logger.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <vector>
+
+namespace omnigraph {
+
+/**
+ * Monotone priority queue for integer keys: keys pushed must not be smaller
+ * than the last popped one, which always holds in Dijkstra with non-negative lengths.
+ * Element with key k is kept in the bucket of the highest bit where k differs from
+ * the last popped key, so every element is moved between buckets at most 64 times.
+ */
+template<typename Value>
+class RadixHeap {
+    typedef std::pair<size_t, Value> entry_t;
+
+    std::array<std::vector<entry_t>, 65> buckets_;
+    size_t last_;
+    size_t size_;
+
+    static unsigned BucketIdx(size_t key, size_t last) {
+        return key == last ? 0 : 64 - unsigned(__builtin_clzll(key ^ last));
+    }
+
+    void Refill() {
+        if (!buckets_[0].empty())
+            return;
+
+        unsigned i = 1;
+        while (buckets_[i].empty())
+            ++i;
+
+        size_t new_last = std::numeric_limits<size_t>::max();
+        for (const auto &entry : buckets_[i])
+            new_last = std::min(new_last, entry.first);
+        last_ = new_last;
+
+        for (const auto &entry : buckets_[i])
+            buckets_[BucketIdx(entry.first, last_)].push_back(entry);
+        buckets_[i].clear();
+    }
+
+public:
+    RadixHeap()
+            : last_(0), size_(0) {}
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    void push(size_t key, Value value) {
+        VERIFY(key >= last_);
+        buckets_[BucketIdx(key, last_)].emplace_back(key, value);
+        size_ += 1;
+    }
+
+    size_t top_key() {
+        VERIFY(!empty());
+        Refill();
+        return last_;
+    }
+
+    entry_t pop() {
+        VERIFY(!empty());
+        Refill();
+        entry_t entry = buckets_[0].back();
+        buckets_[0].pop_back();
+        size_ -= 1;
+        return entry;
+    }
+
+    // Keeps the allocated bucket memory
+    void clear() {
+        for (auto &bucket : buckets_)
+            bucket.clear();
+        last_ = 0;
+        size_ = 0;
+    }
+};
+
+/**
+ * Distance labels of a single search direction, stored in dense arrays indexed by vertex int ids.
+ * Labels are invalidated in O(1) by advancing the epoch, so the same labels can be reused by
+ * millions of short searches without clearing or rehashing.
+ */
+class DistanceLabels {
+    std::vector<uint32_t> reached_;
+    std::vector<uint32_t> settled_;
+    std::vector<size_t> distance_;
+    uint32_t epoch_;
+
+    void EnsureCapacity(size_t id) {
+        if (id < reached_.size())
+            return;
+        size_t sz = std::max(id + 1, 2 * reached_.size());
+        reached_.resize(sz, 0);
+        settled_.resize(sz, 0);
+        distance_.resize(sz);
+    }
+
+public:
+    DistanceLabels()
+            : epoch_(0) {}
+
+    void Reset() {
+        if (++epoch_ == 0) {
+            std::fill(reached_.begin(), reached_.end(), 0);
+            std::fill(settled_.begin(), settled_.end(), 0);
+            epoch_ = 1;
+        }
+    }
+
+    bool reached(size_t id) const {
+        return id < reached_.size() && reached_[id] == epoch_;
+    }
+
+    bool settled(size_t id) const {
+        return id < settled_.size() && settled_[id] == epoch_;
+    }
+
+    size_t distance(size_t id) const {
+        VERIFY(reached(id));
+        return distance_[id];
+    }
+
+    // Returns false if the vertex already has a label not greater than dist
+    bool Relax(size_t id, size_t dist) {
+        EnsureCapacity(id);
+        if (reached_[id] == epoch_ && distance_[id] <= dist)
+            return false;
+        reached_[id] = epoch_;
+        distance_[id] = dist;
+        return true;
+    }
+
+    void Settle(size_t id) {
+        settled_[id] = epoch_;
+    }
+};
+
+/**
+ * Scratch memory of a point-to-point search. Should be kept by the caller between the searches,
+ * one workspace per thread.
+ */
+template<class Graph>
+struct DijkstraWorkspace {
+    typedef typename Graph::VertexId VertexId;
+
+    DistanceLabels forward, backward;
+    RadixHeap<VertexId> forward_queue, backward_queue;
+
+    void Reset() {
+        forward.Reset();
+        backward.Reset();
+        forward_queue.clear();
+        backward_queue.clear();
+    }
+};
+
+/**
+ * Bounded point-to-point shortest distance, searching forward from the start and backward from the end
+ * at the same time. Typically settles a small fraction of the vertices settled by the bounded Dijkstra
+ * from the start.
+ * Topology should provide OutgoingEdges, IncomingEdges, EdgeStart, EdgeEnd and length,
+ * e.g. Graph itself or CompactGraphLayout<Graph>.
+ */
+template<class Graph, class Topology = Graph>
+class BidirectionalDijkstra {
+    typedef typename Graph::VertexId VertexId;
+    typedef typename Graph::EdgeId EdgeId;
+
+    const Topology &topology_;
+    const size_t distance_bound_;
+    const size_t max_vertex_number_;
+    bool vertex_limit_exceeded_;
+
+    // Returns false if the vertex was settled before
+    template<bool forward>
+    bool Step(DijkstraWorkspace<Graph> &ws, size_t &best) {
+        auto &queue = forward ? ws.forward_queue : ws.backward_queue;
+        DistanceLabels &labels = forward ? ws.forward : ws.backward;
+        const DistanceLabels &other = forward ? ws.backward : ws.forward;
+
+        auto entry = queue.pop();
+        size_t dist = entry.first;
+        VertexId v = entry.second;
+        if (labels.settled(v.int_id()) || labels.distance(v.int_id()) < dist)
+            return false;
+        labels.Settle(v.int_id());
+
+        auto process = [&](EdgeId e, VertexId u) {
+            size_t new_dist = dist + topology_.length(e);
+            if (new_dist > distance_bound_ || !labels.Relax(u.int_id(), new_dist))
+                return;
+            queue.push(new_dist, u);
+            if (other.reached(u.int_id()))
+                best = std::min(best, new_dist + other.distance(u.int_id()));
+        };
+
+        if (forward) {
+            for (EdgeId e : topology_.OutgoingEdges(v))
+                process(e, topology_.EdgeEnd(e));
+        } else {
+            for (EdgeId e : topology_.IncomingEdges(v))
+                process(e, topology_.EdgeStart(e));
+        }
+        return true;
+    }
+
+public:
+    BidirectionalDijkstra(const Topology &topology, size_t distance_bound,
+                          size_t max_vertex_number = size_t(-1))
+            : topology_(topology),
+              distance_bound_(distance_bound),
+              max_vertex_number_(max_vertex_number),
+              vertex_limit_exceeded_(false) {}
+
+    /**
+     * @return length of the shortest path from start to end if it does not exceed the distance bound,
+     * size_t(-1) otherwise or if more than max_vertex_number vertices had to be settled
+     */
+    size_t Distance(VertexId start, VertexId end, DijkstraWorkspace<Graph> &ws) {
+        vertex_limit_exceeded_ = false;
+        if (start == end)
+            return 0;
+
+        ws.Reset();
+        ws.forward.Relax(start.int_id(), 0);
+        ws.forward_queue.push(0, start);
+        ws.backward.Relax(end.int_id(), 0);
+        ws.backward_queue.push(0, end);
+
+        size_t best = size_t(-1);
+        size_t vertex_number = 0;
+        while (!ws.forward_queue.empty() && !ws.backward_queue.empty()) {
+            size_t forward_top = ws.forward_queue.top_key();
+            size_t backward_top = ws.backward_queue.top_key();
+            // every path not seen yet is not shorter than the sum of the queue tops
+            if (forward_top + backward_top >= best || forward_top + backward_top > distance_bound_)
+                break;
+
+            bool settled = (ws.forward_queue.size() <= ws.backward_queue.size()) ?
+                           Step<true>(ws, best) : Step<false>(ws, best);
+            if (settled && ++vertex_number > max_vertex_number_) {
+                TRACE("Vertex limit exceeded");
+                vertex_limit_exceeded_ = true;
+                return size_t(-1);
+            }
+        }
+
+        return best <= distance_bound_ ? best : size_t(-1);
+    }
+
+    bool VertexLimitExceeded() const {
+        return vertex_limit_exceeded_;
+    }
+
+private:
+    DECL_LOGGER("BidirectionalDijkstra");
+};
+
+}
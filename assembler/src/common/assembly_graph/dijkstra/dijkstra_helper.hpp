@@ -7,6 +7,7 @@
 
 #pragma once
 #include "dijkstra_algorithm.hpp"
+#include "assembly_graph/core/compact_graph_layout.hpp"
 
 namespace omnigraph {
 
@@ -53,6 +54,60 @@ public:
                                collect_traceback);
     }
 
+    //------------------------------
+    // bounded dijkstra over the compact layout
+    //------------------------------
+
+    typedef CompactGraphLayout<Graph> Layout;
+
+    typedef ComposedDijkstraSettings<Graph,
+            LengthCalculator<Layout>,
+            BoundProcessChecker<Graph>,
+            BoundPutChecker<Graph>,
+            ForwardNeighbourIteratorFactory<Layout> > CompactBoundedDijkstraSettings;
+
+    typedef Dijkstra<Graph, CompactBoundedDijkstraSettings> CompactBoundedDijkstra;
+
+    // Layout must be refreshed before the run
+    static CompactBoundedDijkstra CreateCompactBoundedDijkstra(const Graph &graph, const Layout &layout,
+                                                               size_t length_bound,
+                                                               size_t max_vertex_number = -1ul,
+                                                               bool collect_traceback = false) {
+        VERIFY(!layout.stale());
+        return CompactBoundedDijkstra(graph,
+                                      CompactBoundedDijkstraSettings(
+                                          LengthCalculator<Layout>(layout),
+                                          BoundProcessChecker<Graph>(length_bound),
+                                          BoundPutChecker<Graph>(length_bound),
+                                          ForwardNeighbourIteratorFactory<Layout>(layout)),
+                                      max_vertex_number,
+                                      collect_traceback);
+    }
+
+    typedef ComposedDijkstraSettings<Graph,
+            LengthCalculator<Layout>,
+            BoundProcessChecker<Graph>,
+            BoundPutChecker<Graph>,
+            BackwardNeighbourIteratorFactory<Layout> > CompactBackwardBoundedDijkstraSettings;
+
+    typedef Dijkstra<Graph, CompactBackwardBoundedDijkstraSettings> CompactBackwardBoundedDijkstra;
+
+    static CompactBackwardBoundedDijkstra
+    CreateCompactBackwardBoundedDijkstra(const Graph &graph, const Layout &layout,
+                                         size_t bound,
+                                         size_t max_vertex_number = size_t(-1),
+                                         bool collect_traceback = false) {
+        VERIFY(!layout.stale());
+        return CompactBackwardBoundedDijkstra(graph,
+                                              CompactBackwardBoundedDijkstraSettings(
+                                                  LengthCalculator<Layout>(layout),
+                                                  BoundProcessChecker<Graph>(bound),
+                                                  BoundPutChecker<Graph>(bound),
+                                                  BackwardNeighbourIteratorFactory<Layout>(layout)),
+                                              max_vertex_number,
+                                              collect_traceback);
+    }
+
     //------------------------------
     // bounded backward dijkstra
     //------------------------------
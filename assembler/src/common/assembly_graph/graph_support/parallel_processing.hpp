@@ -9,6 +9,7 @@
 
 #include "utils/logger/logger.hpp"
 #include "assembly_graph/core/graph_iterators.hpp"
+#include "assembly_graph/core/observable_graph.hpp"
 #include "assembly_graph/graph_support/graph_processing_algorithm.hpp"
 #include "utils/parallel/openmp_wrapper.h"
 
@@ -401,8 +402,12 @@ class ParallelEdgeRemovingAlgorithm : public PersistentProcessingAlgorithm<Graph
     typedef typename Graph::EdgeId EdgeId;
     typedef PersistentProcessingAlgorithm<Graph, EdgeId, Comparator> base;
 
+    //bounds the memory held by the event log and by deleted, but not yet destroyed elements
+    static const size_t MAX_BATCH_EVENTS = 1 << 16;
+
     const func::TypedPredicate<EdgeId> remove_condition_;
     EdgeRemover<Graph> edge_remover_;
+    std::unique_ptr<EventBatch<Graph>> batch_;
 
 protected:
 
@@ -411,6 +416,7 @@ protected:
         if (remove_condition_(e)) {
             TRACE("Check passed, removing");
             edge_remover_.DeleteEdge(e);
+            batch_->CommitIfExceeds(MAX_BATCH_EVENTS);
             return true;
         }
         TRACE("Check not passed");
@@ -432,6 +438,18 @@ public:
                    edge_remover_(g, removal_handler) {
     }
 
+    /**
+     * Deferrable handlers receive the events of the run in batches of at most MAX_BATCH_EVENTS
+     * (plus the events of a single removal), see EventBatch.
+     */
+    size_t Run(bool force_primary_launch = false,
+               double iter_run_progress = 1.) override {
+        batch_.reset(new EventBatch<Graph>(this->g()));
+        size_t triggered = base::Run(force_primary_launch, iter_run_progress);
+        batch_.reset();
+        return triggered;
+    }
+
 private:
     DECL_LOGGER("ParallelEdgeRemovingAlgorithm");
 };
@@ -218,9 +218,10 @@ bool ScaffoldingUniqueEdgeAnalyzer::FindCommonChildren(const vector<pair<EdgeId,
     return true;
 }
 
-bool ScaffoldingUniqueEdgeAnalyzer::FindCommonChildren(EdgeId from, size_t lib_index) const{
+bool ScaffoldingUniqueEdgeAnalyzer::FindCommonChildren(EdgeId from,
+                                                       const path_extend::FrozenPairedInfoIndex &paired_index) const {
     DEBUG("processing unique edge " << gp_.g.int_id(from));
-    auto next_edges = gp_.clustered_indices[lib_index].Get(from);
+    auto next_edges = paired_index.Get(from);
     vector<pair<EdgeId, double>> next_weights;
     for (auto hist_pair: next_edges) {
         if (hist_pair.first == from || hist_pair.first == gp_.g.conjugate(from))
@@ -243,11 +244,11 @@ bool ScaffoldingUniqueEdgeAnalyzer::FindCommonChildren(EdgeId from, size_t lib_i
 }
 
 
-void ScaffoldingUniqueEdgeAnalyzer::ClearLongEdgesWithPairedLib(size_t lib_index,
+void ScaffoldingUniqueEdgeAnalyzer::ClearLongEdgesWithPairedLib(const path_extend::FrozenPairedInfoIndex &paired_index,
                                                                 ScaffoldingUniqueEdgeStorage &storage) const {
     set<EdgeId> to_erase;
     for (EdgeId edge: storage) {
-        if (!FindCommonChildren(edge, lib_index)) {
+        if (!FindCommonChildren(edge, paired_index)) {
             to_erase.insert(edge);
             to_erase.insert(gp_.g.conjugate(edge));
         }
@@ -79,7 +79,7 @@ class ScaffoldingUniqueEdgeAnalyzer {
     std::set<VertexId> GetChildren(VertexId v, std::map<VertexId, std::set<VertexId>> &dijkstra_cash) const;
     bool FindCommonChildren(EdgeId e1, EdgeId e2, std::map<VertexId, std::set<VertexId>> &dijkstra_cash) const;
     bool FindCommonChildren(const std::vector<std::pair<EdgeId, double>> &next_weights) const;
-    bool FindCommonChildren(EdgeId from, size_t lib_index) const;
+    bool FindCommonChildren(EdgeId from, const path_extend::FrozenPairedInfoIndex &paired_index) const;
     std::map<EdgeId, size_t> FillNextEdgeVoting(BidirectionalPathMap<size_t>& active_paths, int direction) const;
     bool ConservativeByPaths(EdgeId e, const GraphCoverageMap &long_reads_cov_map,
                              const pe_config::LongReads &lr_config) const;
@@ -101,7 +101,8 @@ public:
         SetCoverageBasedCutoff();
     }
     void FillUniqueEdgeStorage(ScaffoldingUniqueEdgeStorage &storage);
-    void ClearLongEdgesWithPairedLib(size_t lib_index, ScaffoldingUniqueEdgeStorage &storage) const;
+    void ClearLongEdgesWithPairedLib(const path_extend::FrozenPairedInfoIndex &paired_index,
+                                     ScaffoldingUniqueEdgeStorage &storage) const;
     void FillUniqueEdgesWithLongReads(GraphCoverageMap &long_reads_cov_map,
                                       ScaffoldingUniqueEdgeStorage &unique_storage_pb,
                                       const pe_config::LongReads &lr_config);
@@ -130,9 +131,17 @@ public:
         used_.insert(g_.conjugate(e));
     }
 
-//    const ScaffoldingUniqueEdgeStorage& unique_edge_storage() const {
-//        return unique_;
-//    }
+    const ScaffoldingUniqueEdgeStorage& unique_edge_storage() const {
+        return unique_;
+    }
+
+    void insert_all(const UsedUniqueStorage &other) {
+        used_.insert(other.used_.begin(), other.used_.end());
+    }
+
+    void clear() {
+        used_.clear();
+    }
 
     bool IsUsedAndUnique(EdgeId e) const {
         return (unique_.IsUnique(e) && used_.find(e) != used_.end());
@@ -214,6 +214,10 @@ public:
         edges_positions_.erase(e);
     }
 
+    bool IsDeferrable() const override {
+        return true;
+    }
+
     void clear() {
         edges_positions_.clear();
     }
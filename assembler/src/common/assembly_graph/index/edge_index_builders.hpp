@@ -39,10 +39,8 @@ DeBruijnGraphKMerSplitter<Graph, KmerFilter>::FillBufferFromEdges(EdgeRange &r,
                                                                   unsigned thread_id) {
     size_t seqs = 0;
     for (auto &it = r.begin(); it != r.end(); ++it) {
-        const Sequence &nucls = g_.EdgeNucls(*it);
-
         seqs += 1;
-        if (this->FillBufferFromSequence(nucls, thread_id))
+        if (this->FillBufferFromSequence(g_.EdgeNuclsView(*it), thread_id))
             break;
     }
 
@@ -34,7 +34,8 @@ class EdgeInfoUpdater {
         return false;
     }
 
-    void UpdateKMers(const Sequence &nucls, EdgeId e) {
+    template<class Seq>
+    void UpdateKMers(const Seq &nucls, EdgeId e) {
         VERIFY(nucls.size() >= index_.k());
         KeyWithHash kwh = index_.ConstructKWH(Kmer(index_.k(), nucls));
         if (kwh.is_minimal())
@@ -46,7 +47,8 @@ class EdgeInfoUpdater {
         }
     }
 
-    void DeleteKMers(const Sequence &nucls, EdgeId e) {
+    template<class Seq>
+    void DeleteKMers(const Seq &nucls, EdgeId e) {
         VERIFY(nucls.size() >= index_.k());
         KeyWithHash kwh = index_.ConstructKWH(Kmer(index_.k(), nucls));
         DeleteIfEqual(kwh, e);
@@ -66,13 +68,11 @@ class EdgeInfoUpdater {
             : g_(g), index_(index) { }
 
     void UpdateKmers(EdgeId e) {
-        const Sequence &nucls = g_.EdgeNucls(e);
-        UpdateKMers(nucls, e);
+        UpdateKMers(g_.EdgeNuclsView(e), e);
     }
 
     void DeleteKmers(EdgeId e) {
-        Sequence nucls = g_.EdgeNucls(e);
-        DeleteKMers(nucls, e);
+        DeleteKMers(g_.EdgeNuclsView(e), e);
     }
 
     void UpdateAll() {
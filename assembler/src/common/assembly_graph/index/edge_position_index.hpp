@@ -137,7 +137,7 @@ public:
         if (!entry.valid())
             return false;
 
-        return graph_.EdgeNucls(entry.edge()).contains(kwh.key(), entry.offset());
+        return graph_.EdgeNuclsView(entry.edge()).contains(kwh.key(), entry.offset());
     }
 
     void PutInIndex(KeyWithHash &kwh, IdType id, size_t offset) {
@@ -110,7 +110,7 @@ class BidirectionalPath : public PathListener {
     std::deque<size_t> cumulative_len_;
     std::deque<Gap> gap_len_;  // e0 -> gap1 -> e1 -> ... -> gapN -> eN; gap0 = 0
     std::vector<PathListener *> listeners_;
-    const uint64_t id_;  //Unique ID
+    uint64_t id_;  //Unique ID
     float weight_;
 
 public:
@@ -160,14 +160,15 @@ public:
         listeners_.push_back(listener);
     }
 
-//    void Unsubscribe(PathListener * listener) {
-//        for (auto it = listeners_.begin(); it != listeners_.end(); ++it) {
-//            if (*it == listener) {
-//                listeners_.erase(it);
-//                break;
-//            }
-//        }
-//    }
+    bool Unsubscribe(PathListener * listener) {
+        for (auto it = listeners_.begin(); it != listeners_.end(); ++it) {
+            if (*it == listener) {
+                listeners_.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
 
     void SetConjPath(BidirectionalPath* path) {
         conj_path_ = path;
@@ -239,6 +240,17 @@ public:
         return id_;
     }
 
+    //Reserves a block of count consecutive unused ids, returns the first one
+    static uint64_t ReserveIds(size_t count) {
+        return path_id_.fetch_add(count);
+    }
+
+    //Ids define the order of paths in coverage maps and path sets,
+    //so the path must not be stored in any of them while its id is changed
+    void SetId(uint64_t id) {
+        id_ = id;
+    }
+
     EdgeId Back() const {
         return data_.back();
     }
@@ -136,6 +136,12 @@ public:
         return true;
     }
 
+    //Takes ownership of the pair that is already linked (e.g. by AddPair of another container)
+    void AddLinkedPair(BidirectionalPath* p, BidirectionalPath* cp) {
+        VERIFY(p->GetConjPath() == cp && cp->GetConjPath() == p);
+        data_.emplace_back(p, cp);
+    }
+
     void SortByLength(bool desc = true) {
         std::stable_sort(data_.begin(), data_.end(), [=](const PathPair& p1, const PathPair& p2) {
             if (p1.first->Empty() || p2.first->Empty() || p1.first->Length() != p2.first->Length()) {
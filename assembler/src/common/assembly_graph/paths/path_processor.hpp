@@ -26,29 +26,37 @@ const std::string PrintPath(const Graph &g, const std::vector<typename Graph::Ed
 
 
 template<class Graph>
-class PathProcessor {
+class PathProcessorCallback {
     typedef typename Graph::EdgeId EdgeId;
-    typedef typename Graph::VertexId VertexId;
     typedef std::vector<EdgeId> Path;
-    typedef typename DijkstraHelper<Graph>::BoundedDijkstra DijkstraT;
+
 public:
-    class Callback {
+    virtual ~PathProcessorCallback() {
+    }
 
-    public:
-        virtual ~Callback() {
-        }
+    virtual void HandleReversedPath(const std::vector<EdgeId> &reversed_path) = 0;
 
-        virtual void HandleReversedPath(const std::vector<EdgeId> &reversed_path) = 0;
 
+protected:
+    Path ReversePath(const Path &path) const {
+        Path result;
+        for (auto it = path.rbegin(), end = path.rend(); it != end; ++it)
+            result.push_back(*it);
+        return result;
+    }
+};
 
-    protected:
-        Path ReversePath(const Path &path) const {
-            Path result;
-            for (auto it = path.rbegin(), end = path.rend(); it != end; ++it)
-                result.push_back(*it);
-            return result;
-        }
-    };
+/**
+ * DijkstraT is the bounded dijkstra limiting the search, either over the graph
+ * itself (default) or over its compact layout, see DijkstraHelper
+ */
+template<class Graph, class DijkstraT = typename DijkstraHelper<Graph>::BoundedDijkstra>
+class PathProcessor {
+    typedef typename Graph::EdgeId EdgeId;
+    typedef typename Graph::VertexId VertexId;
+    typedef std::vector<EdgeId> Path;
+public:
+    typedef PathProcessorCallback<Graph> Callback;
 
 private:
 
@@ -185,10 +193,14 @@ public:
 
     PathProcessor(const Graph& g, VertexId start, size_t length_bound,
                   size_t dijkstra_vertex_limit = MAX_DIJKSTRA_VERTICES) :
+              PathProcessor(g, start, DijkstraHelper<Graph>::CreateBoundedDijkstra(g, length_bound,
+                                                                                   dijkstra_vertex_limit)) {
+    }
+
+    PathProcessor(const Graph& g, VertexId start, DijkstraT dijkstra) :
               g_(g),
               start_(start),
-              dijkstra_(DijkstraHelper<Graph>::CreateBoundedDijkstra(g, length_bound,
-                                                                     dijkstra_vertex_limit)) {
+              dijkstra_(std::move(dijkstra)) {
         TRACE("Dijkstra launched");
         dijkstra_.Run(start);
         TRACE("Dijkstra finished");
@@ -218,6 +230,10 @@ public:
         return error_code;
     }
 
+    const DijkstraT &dijkstra() const {
+        return dijkstra_;
+    }
+
     static const size_t MAX_CALL_CNT = 3000;
     static const size_t MAX_DIJKSTRA_VERTICES = 3000;
     static const size_t VERTEX_USAGE_ENABLE_THRESHOLD = 500;
@@ -239,6 +255,26 @@ int ProcessPaths(const Graph& g, size_t min_len, size_t max_len,
     return processor.Process(end, min_len, max_len, callback, max_edge_cnt);
 }
 
+/**
+ * Same as above, runs the dijkstra over the compact layout of the graph,
+ * unless the layout is missing or outdated
+ */
+template<class Graph>
+int ProcessPaths(const Graph& g, const CompactGraphLayout<Graph> *layout,
+                 size_t min_len, size_t max_len,
+                 typename Graph::VertexId start, typename Graph::VertexId end,
+                 typename PathProcessor<Graph>::Callback& callback,
+                 size_t max_edge_cnt = std::numeric_limits<size_t>::max()) {
+    if (!layout || layout->stale())
+        return ProcessPaths(g, min_len, max_len, start, end, callback, max_edge_cnt);
+
+    typedef typename DijkstraHelper<Graph>::CompactBoundedDijkstra CompactDijkstra;
+    PathProcessor<Graph, CompactDijkstra> processor(g, start,
+            DijkstraHelper<Graph>::CreateCompactBoundedDijkstra(g, *layout, max_len,
+                                                                 PathProcessor<Graph>::MAX_DIJKSTRA_VERTICES));
+    return processor.Process(end, min_len, max_len, callback, max_edge_cnt);
+}
+
 template<class Graph>
 class AdapterCallback: public PathProcessor<Graph>::Callback {
     typedef typename Graph::EdgeId EdgeId;
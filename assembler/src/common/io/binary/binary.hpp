@@ -543,6 +543,10 @@ public:
         return !str_;
     }
 
+    std::ostream &stream() {
+        return str_;
+    }
+
 private:
     std::ostream &str_;
 };
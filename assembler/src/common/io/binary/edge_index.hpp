@@ -7,12 +7,21 @@
 #pragma once
 
 #include "io_base.hpp"
+#include "io/kmers/mmapped_reader.hpp"
 #include "modules/alignment/edge_index.hpp"
 
+#include <streambuf>
+#include <cstring>
+
 namespace io {
 
 namespace binary {
 
+/**
+ * @brief  Saver/loader of the k-mer edge index. The file starts with the fingerprint of the graph
+ *         edge set the index was built for, so the index could be mapped back on checkpoint load
+ *         and validated without rebuilding it. Stale indices are not loaded and get refilled.
+ */
 template<typename Graph>
 class EdgeIndexIO : public IOSingle<debruijn_graph::EdgeIndex<Graph>> {
 public:
@@ -21,19 +30,91 @@ public:
             : IOSingle<Type>("edge index", ".kmidx") {
     }
 
+    bool Load(const std::string &basename, Type &value) override {
+        std::string filename = basename + this->ext_;
+        VERIFY_MSG(fs::check_existence(filename), "File not found: " + filename);
+        if (fs::filesize(filename) == 0)
+            return false;
+
+        DEBUG("Mapping " << this->name_ << " from " << filename);
+        MMappedReader reader(filename, /* unlink */ false, -1ULL);
+        const char *data = static_cast<const char*>(reader.data());
+        size_t size = reader.size();
+
+        Header header;
+        if (size < sizeof(header)) {
+            INFO("Edge index " << filename << " is in outdated format, will be rebuilt");
+            return false;
+        }
+        memcpy(&header, data, sizeof(header));
+        if (header.magic != MAGIC) {
+            INFO("Edge index " << filename << " is in outdated format, will be rebuilt");
+            return false;
+        }
+        if (header.k != value.k() || header.fingerprint != Fingerprint(value.g())) {
+            INFO("Edge index " << filename << " does not match the graph, will be rebuilt");
+            return false;
+        }
+
+        // Value array and MPHF are bulk-copied straight from the mapped pages
+        reader.advise(MADV_SEQUENTIAL);
+        MappedBuf buf(data, size);
+        std::istream is(&buf);
+        BinIStream str(is);
+        this->LoadImpl(str, value);
+        VERIFY_MSG(is, "Failed to read " << filename);
+        return true;
+    }
+
     void SaveImpl(BinOStream &str, const Type &value) override {
         const auto &index = value.inner_index();
-        str << (uint32_t)index.k() << index;
+        Header header = { MAGIC, Fingerprint(value.g()), (uint32_t)index.k(), 0 };
+        str.stream().write(reinterpret_cast<const char*>(&header), sizeof(header));
+        str << index;
     }
 
     void LoadImpl(BinIStream &str, Type &value) override {
         auto &index = value.inner_index();
-        uint32_t k_;
-        str >> k_;
-        VERIFY_MSG(k_ == index.k(), "Cannot read edge index, different Ks");
+        Header header;
+        str.stream().read(reinterpret_cast<char*>(&header), sizeof(header));
+        VERIFY_MSG(header.magic == MAGIC, "Cannot read edge index, unknown format");
+        VERIFY_MSG(header.k == index.k(), "Cannot read edge index, different Ks");
+        VERIFY_MSG(header.fingerprint == Fingerprint(value.g()), "Cannot read edge index, graph was changed");
         index.clear();
         str >> index;
     }
+
+private:
+    static const uint64_t MAGIC = 0x31584449454d4bULL; // "KMEIDX1"
+
+    // Fixed-size header, so it could be checked right in the mapped file
+    struct Header {
+        uint64_t magic;
+        uint64_t fingerprint;
+        uint32_t k;
+        uint32_t reserved;
+    };
+
+    // Order-independent hash of the (id, length) pairs of all edges
+    static uint64_t Fingerprint(const Graph &g) {
+        uint64_t res = g.e_size();
+        for (typename Graph::EdgeId e : g.edges()) {
+            uint64_t h = (e.int_id() << 32) ^ g.length(e);
+            h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+            res += h ^ (h >> 31);
+        }
+        return res;
+    }
+
+    // Read-only stream buffer over the mapped file
+    class MappedBuf : public std::streambuf {
+    public:
+        MappedBuf(const char *data, size_t size) {
+            char *begin = const_cast<char*>(data);
+            setg(begin, begin, begin + size);
+        }
+    };
 };
 
 template<typename Graph>
@@ -169,9 +169,10 @@ public:
         return file_is_present;
     }
 
-private:
+protected:
     const char *name_, *ext_;
 
+private:
     virtual void SaveImpl(BinOStream &str, const T &value) = 0;
     virtual void LoadImpl(BinIStream &str, T &value) = 0;
 
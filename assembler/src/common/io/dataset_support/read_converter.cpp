@@ -62,7 +62,8 @@ bool ReadConverter::LoadLibIfExists(SequencingLibraryT& lib) {
 }
 
 void ReadConverter::ConvertToBinary(SequencingLibraryT& lib,
-                                    ThreadPool::ThreadPool *pool) {
+                                    ThreadPool::ThreadPool *pool,
+                                    bool compressed) {
     auto& data = lib.data();
     std::ofstream info;
     info.open(data.binary_reads_info.bin_reads_info_file, std::ios_base::out);
@@ -71,7 +72,7 @@ void ReadConverter::ConvertToBinary(SequencingLibraryT& lib,
 
     INFO("Converting reads to binary format for library #" << data.lib_index << " (takes a while)");
     INFO("Converting paired reads");
-    BinaryWriter paired_converter(data.binary_reads_info.paired_read_prefix);
+    BinaryWriter paired_converter(data.binary_reads_info.paired_read_prefix, compressed);
 
     PairedStream paired_reader = paired_easy_reader(lib, false, 0, false, PhredOffset, pool);
     ReadStreamStat read_stat = paired_converter.ToBinary(paired_reader, lib.orientation(),
@@ -79,13 +80,13 @@ void ReadConverter::ConvertToBinary(SequencingLibraryT& lib,
     read_stat.read_count *= 2;
 
     INFO("Converting single reads");
-    BinaryWriter single_converter(data.binary_reads_info.single_read_prefix);
+    BinaryWriter single_converter(data.binary_reads_info.single_read_prefix, compressed);
     SingleStream single_reader = single_easy_reader(lib, false, false, true, PhredOffset, pool);
     read_stat.merge(single_converter.ToBinary(single_reader, pool));
 
     data.unmerged_read_length = read_stat.max_len;
     INFO("Converting merged reads");
-    BinaryWriter merged_converter(data.binary_reads_info.merged_read_prefix);
+    BinaryWriter merged_converter(data.binary_reads_info.merged_read_prefix, compressed);
     SingleStream merged_reader = merged_easy_reader(lib, false, true, PhredOffset, pool);
     auto merged_stats = merged_converter.ToBinary(merged_reader, pool);
 
@@ -132,7 +133,7 @@ void ReadConverter::WriteBinaryInfo(const std::string &filename, LibraryData &da
     data.binary_reads_info.binary_converted = true;
 }
 
-void ConvertIfNeeded(DataSet<LibraryData> &data, unsigned nthreads) {
+void ConvertIfNeeded(DataSet<LibraryData> &data, unsigned nthreads, bool compressed) {
     std::unique_ptr<ThreadPool::ThreadPool> pool;
 
     if (nthreads > 1)
@@ -140,7 +141,7 @@ void ConvertIfNeeded(DataSet<LibraryData> &data, unsigned nthreads) {
 
     for (auto &lib : data) {
         if (!ReadConverter::LoadLibIfExists(lib))
-            ReadConverter::ConvertToBinary(lib, pool.get());
+            ReadConverter::ConvertToBinary(lib, pool.get(), compressed);
     }
 }
 
@@ -30,13 +30,14 @@ class ReadConverter {
 public:
     static bool LoadLibIfExists(SequencingLibraryT& lib);
     static void ConvertToBinary(SequencingLibraryT& lib,
-                                ThreadPool::ThreadPool *pool = nullptr);
+                                ThreadPool::ThreadPool *pool = nullptr,
+                                bool compressed = false);
 
     static void ConvertEdgeSequencesToBinary(const debruijn_graph::Graph &g, const std::string &contigs_output_dir,
                                              unsigned nthreads);
 };
 
-void ConvertIfNeeded(DataSet<LibraryData> &data, unsigned nthreads);
+void ConvertIfNeeded(DataSet<LibraryData> &data, unsigned nthreads, bool compressed = false);
 
 BinaryPairedStreams paired_binary_readers(SequencingLibraryT &lib,
                                           bool followed_by_rc,
@@ -191,6 +191,17 @@ public:
         return BytesRead < FileSize;
     }
 
+    // Hint the kernel about access pattern (madvise(2) advice) of the current
+    // block starting from the given offset inside it
+    void advise(int advice, size_t offset = 0) const {
+        size_t PageSize = getpagesize();
+        offset = offset / PageSize * PageSize;
+        if (!MappedRegion || offset >= BlockSize)
+            return;
+
+        madvise(MappedRegion + offset, BlockSize - offset, advice);
+    }
+
     size_t size() const { return FileSize; }
 
     size_t data_size() const { return FileSize; }
@@ -56,7 +56,16 @@ ReadStreamStat BinaryWriter::ToBinary(const Writer &writer, io::ReadStream<Read>
 
     // Reserve space for stats
     ReadStreamStat read_stats;
-    read_stats.write(*file_ds_);
+    WriteHeader(read_stats);
+
+    // Compressed blocks follow the header
+    std::unique_ptr<BlockCompressingStreamBuf> compressing_buf;
+    std::unique_ptr<std::ostream> compressed_ds;
+    if (compressed_) {
+        compressing_buf = std::make_unique<BlockCompressingStreamBuf>(*file_ds_);
+        compressed_ds = std::make_unique<std::ostream>(compressing_buf.get());
+    }
+    std::ostream &out = compressed_ds ? *compressed_ds : *file_ds_;
 
     size_t rest = 1;
     std::future<void> flush_task;
@@ -71,11 +80,11 @@ ReadStreamStat BinaryWriter::ToBinary(const Writer &writer, io::ReadStream<Read>
         auto flush_job = [&] {
             for (const Read &read : flush_buf) {
                 if (!--rest) {
-                    auto offset = (size_t)file_ds_->tellp();
+                    auto offset = compressing_buf ? compressing_buf->tell() : (size_t)file_ds_->tellp();
                     offset_ds_->write(reinterpret_cast<const char*>(&offset), sizeof(offset));
                     rest = CHUNK;
                 }
-                writer.Write(*file_ds_, read);
+                writer.Write(out, read);
             }
             flush_buf.clear();
         };
@@ -103,19 +112,30 @@ ReadStreamStat BinaryWriter::ToBinary(const Writer &writer, io::ReadStream<Read>
     if (flush_task.valid())
         flush_task.wait();
     VERIFY(flush_buf.size() == 0);
+    if (compressing_buf)
+        compressing_buf->pubsync();
 
     // Rewrite the reserved space with actual stats
-    file_ds_->seekp(0);
-    read_stats.write(*file_ds_);
+    WriteHeader(read_stats);
 
     INFO(read_count << " reads written");
     return read_stats;
 }
 
-BinaryWriter::BinaryWriter(const std::string &file_name_prefix)
+constexpr uint64_t BinaryWriter::COMPRESSED_MAGIC;
+
+void BinaryWriter::WriteHeader(const ReadStreamStat &read_stats) {
+    file_ds_->seekp(0);
+    if (compressed_)
+        file_ds_->write(reinterpret_cast<const char*>(&COMPRESSED_MAGIC), sizeof(COMPRESSED_MAGIC));
+    read_stats.write(*file_ds_);
+}
+
+BinaryWriter::BinaryWriter(const std::string &file_name_prefix, bool compressed)
             : file_name_prefix_(file_name_prefix),
               file_ds_(std::make_unique<std::ofstream>(file_name_prefix_ + ".seq", std::ios_base::binary)),
-              offset_ds_(std::make_unique<std::ofstream>(file_name_prefix_ + ".off", std::ios_base::binary))
+              offset_ds_(std::make_unique<std::ofstream>(file_name_prefix_ + ".off", std::ios_base::binary)),
+              compressed_(compressed)
 {}
 
 ReadStreamStat BinaryWriter::ToBinary(io::ReadStream<io::SingleReadSeq>& stream,
@@ -11,6 +11,7 @@
 #include "single_read.hpp"
 #include "paired_read.hpp"
 #include "orientation.hpp"
+#include "block_compression.hpp"
 
 #include "pipeline/library_fwd.hpp"
 
@@ -25,6 +26,9 @@ namespace io {
 class BinaryWriter {
     const std::string file_name_prefix_;
     std::unique_ptr<std::ofstream> file_ds_, offset_ds_;
+    bool compressed_;
+
+    void WriteHeader(const ReadStreamStat &read_stats);
 
     template<class Writer, class Read>
     ReadStreamStat ToBinary(const Writer &writer, io::ReadStream<Read> &stream,
@@ -34,8 +38,13 @@ public:
     typedef size_t CountType;
     static constexpr size_t CHUNK = 100;
     static constexpr size_t BUF_SIZE = 50000;
+    // Marks block-compressed files, precedes the stats header. In the plain
+    // format the header starts with read count which is never that large.
+    static constexpr uint64_t COMPRESSED_MAGIC = 0x315a51455342ULL;
 
-    BinaryWriter(const std::string &file_name_prefix);
+    // When compressed, reads are packed into deflated blocks and .off file
+    // stores virtual offsets of the chunks inside the blocks
+    BinaryWriter(const std::string &file_name_prefix, bool compressed = false);
 
     ~BinaryWriter() = default;
 
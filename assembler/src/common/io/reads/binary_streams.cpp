@@ -14,14 +14,14 @@
 namespace io {
 
 bool BinaryFileSingleStream::ReadImpl(SingleReadSeq &read) {
-    return read.BinRead(stream_);
+    return Decode(read);
 }
 
 BinaryFileSingleStream::BinaryFileSingleStream(const std::string &file_name_prefix, size_t portion_count, size_t portion_num)
         : BinaryFileStream(file_name_prefix, portion_count, portion_num) {}
 
 bool BinaryFilePairedStream::ReadImpl(PairedReadSeq& read) {
-    return read.BinRead(stream_, insert_size_);
+    return Decode(read, insert_size_);
 }
 
 BinaryFilePairedStream::BinaryFilePairedStream(const std::string &file_name_prefix, size_t insert_size,
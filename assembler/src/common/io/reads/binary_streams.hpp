@@ -11,30 +11,58 @@
 #include "single_read.hpp"
 #include "paired_read.hpp"
 #include "binary_converter.hpp"
+#include "io/kmers/mmapped_reader.hpp"
 
 #include "utils/verify.hpp"
 #include "utils/logger/logger.hpp"
 #include "utils/filesystem/path_helper.hpp"
 
 #include <fstream>
+#include <memory>
 
 namespace io {
 
 template<typename SeqT>
 class BinaryFileStream {
-protected:
-    std::ifstream stream_;
+    // Plain files are decoded right from the mapped pages
+    std::unique_ptr<MMappedReader> mapped_;
+    const char *pos_ = nullptr;
+    const char *end_ = nullptr;
+
+    // Compressed ones are read via decompressing buffer. Kept on heap, so the
+    // buffer could refer to the file after move
+    std::unique_ptr<std::ifstream> file_;
+    std::unique_ptr<BlockDecompressingStreamBuf> decompressing_buf_;
+    std::unique_ptr<std::istream> stream_;
 
+protected:
     virtual bool ReadImpl(SeqT &read) = 0;
 
+    template<class... Args>
+    bool Decode(SeqT &read, Args... args) {
+        if (stream_)
+            return read.BinRead(*stream_, args...);
+
+        pos_ = read.BinRead(pos_, end_, args...);
+        VERIFY(pos_ <= end_);
+        return true;
+    }
+
 private:
     size_t offset_, count_, current_;
 
     void Init() {
-        stream_.clear();
-        stream_.seekg(offset_);
-        VERIFY_MSG(stream_.good(), "Stream is not good(), offset_ " << offset_ << " count_ " << count_);
         current_ = 0;
+        if (mapped_) {
+            VERIFY_MSG(offset_ <= mapped_->size(), "Offset " << offset_ << " is beyond the file of size " << mapped_->size());
+            pos_ = static_cast<const char*>(mapped_->data()) + offset_;
+            end_ = static_cast<const char*>(mapped_->data()) + mapped_->size();
+            return;
+        }
+
+        stream_->clear();
+        decompressing_buf_->seek(offset_);
+        VERIFY_MSG(stream_->good(), "Stream is not good(), offset_ " << offset_ << " count_ " << count_);
     }
 
 public:
@@ -48,9 +76,23 @@ public:
         DEBUG("Preparing binary stream #" << portion_num << "/" << portion_count);
         VERIFY(portion_num < portion_count);
         const std::string fname = file_name_prefix + ".seq";
-        stream_.open(fname, std::ios_base::binary | std::ios_base::in);
+        file_ = std::make_unique<std::ifstream>(fname, std::ios_base::binary | std::ios_base::in);
+
+        uint64_t magic = 0;
+        file_->read(reinterpret_cast<char *>(&magic), sizeof(magic));
+        const bool compressed = magic == BinaryWriter::COMPRESSED_MAGIC;
+        if (!compressed)
+            file_->seekg(0);
         ReadStreamStat stat;
-        stat.read(stream_);
+        stat.read(*file_);
+        const size_t header_size = (size_t)file_->tellg();
+        if (compressed) {
+            decompressing_buf_ = std::make_unique<BlockDecompressingStreamBuf>(*file_);
+            stream_ = std::make_unique<std::istream>(decompressing_buf_.get());
+        } else {
+            file_.reset();
+            mapped_ = std::make_unique<MMappedReader>(fname, false, -1ULL);
+        }
 
         const std::string offset_name = file_name_prefix + ".off";
         const size_t chunk_count = fs::filesize(offset_name) / sizeof(size_t);
@@ -87,11 +129,15 @@ public:
             DEBUG("Reads " << start_num << "-" << start_num + count_ << "/" << stat.read_count << " from " << offset_);
         } else {  // current portion has size 0 (the case of chunk_count == 0 is also included here)
             // Setup safe offset value
-            offset_ = sizeof(ReadStreamStat);
+            offset_ = compressed ? block_compression::VirtualOffset(header_size, 0) : header_size;
             count_ = 0;
             DEBUG("Empty BinaryFileStream constructed");
         }
 
+        // Every portion is read through once per pass
+        if (mapped_)
+            mapped_->advise(MADV_SEQUENTIAL, offset_);
+
         Init();
     }
 
@@ -109,7 +155,7 @@ public:
     }
 
     bool is_open() {
-        return stream_.is_open();
+        return mapped_ || (file_ && file_->is_open());
     }
 
     bool eof() {
@@ -118,7 +164,9 @@ public:
 
     void close() {
         current_ = 0;
-        stream_.close();
+        mapped_.reset();
+        if (file_)
+            file_->close();
     }
 
     void reset() {
@@ -0,0 +1,152 @@
+//***************************************************************************
+//* Copyright (c) 2019 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#include "block_compression.hpp"
+
+#include "utils/verify.hpp"
+
+#include <cstring>
+
+namespace io {
+
+using namespace block_compression;
+
+// Block layout: packed size, unpacked size (both uint32_t), packed data.
+// Incompressible blocks are stored as is, packed size is equal to unpacked one then.
+bool BlockCompressingStreamBuf::FlushBlock() {
+    uint32_t raw_size = uint32_t(pptr() - pbase());
+    if (!raw_size)
+        return true;
+
+    deflateReset(&zs_);
+    zs_.next_in = reinterpret_cast<Bytef*>(pbase());
+    zs_.avail_in = raw_size;
+    zs_.next_out = reinterpret_cast<Bytef*>(packed_.data());
+    zs_.avail_out = uInt(packed_.size());
+    int res = deflate(&zs_, Z_FINISH);
+
+    const char *data = packed_.data();
+    uint32_t packed_size = uint32_t(packed_.size() - zs_.avail_out);
+    if (res != Z_STREAM_END || packed_size >= raw_size) {
+        data = pbase();
+        packed_size = raw_size;
+    }
+
+    os_.write(reinterpret_cast<const char*>(&packed_size), sizeof(packed_size));
+    os_.write(reinterpret_cast<const char*>(&raw_size), sizeof(raw_size));
+    os_.write(data, packed_size);
+    block_pos_ += sizeof(packed_size) + sizeof(raw_size) + packed_size;
+
+    setp(raw_.data(), raw_.data() + raw_.size());
+    return os_.good();
+}
+
+BlockCompressingStreamBuf::int_type BlockCompressingStreamBuf::overflow(int_type c) {
+    if (!FlushBlock())
+        return traits_type::eof();
+
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+
+    return traits_type::not_eof(c);
+}
+
+int BlockCompressingStreamBuf::sync() {
+    return FlushBlock() ? 0 : -1;
+}
+
+BlockCompressingStreamBuf::BlockCompressingStreamBuf(std::ostream &os, int level)
+        : os_(os), block_pos_(uint64_t(os.tellp())), raw_(BLOCK_SIZE) {
+    memset(&zs_, 0, sizeof(zs_));
+    // Raw deflate, no headers and checksums
+    int res = deflateInit2(&zs_, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+    VERIFY_MSG(res == Z_OK, "Failed to initialize deflate: " << res);
+    packed_.resize(deflateBound(&zs_, BLOCK_SIZE));
+
+    setp(raw_.data(), raw_.data() + raw_.size());
+}
+
+BlockCompressingStreamBuf::~BlockCompressingStreamBuf() {
+    FlushBlock();
+    deflateEnd(&zs_);
+}
+
+uint64_t BlockCompressingStreamBuf::tell() {
+    // In-block offset should fit into 16 bits
+    if (pptr() == epptr())
+        FlushBlock();
+
+    return VirtualOffset(block_pos_, pptr() - pbase());
+}
+
+bool BlockDecompressingStreamBuf::LoadBlock() {
+    uint32_t packed_size, raw_size;
+    is_.read(reinterpret_cast<char*>(&packed_size), sizeof(packed_size));
+    is_.read(reinterpret_cast<char*>(&raw_size), sizeof(raw_size));
+    if (!is_)
+        return false;
+
+    VERIFY_MSG(packed_size <= raw_size && raw_size <= BLOCK_SIZE,
+               "Corrupted compressed block, sizes " << packed_size << " / " << raw_size);
+    if (packed_size == raw_size) {
+        is_.read(raw_.data(), raw_size);
+    } else {
+        is_.read(packed_.data(), packed_size);
+
+        inflateReset(&zs_);
+        zs_.next_in = reinterpret_cast<Bytef*>(packed_.data());
+        zs_.avail_in = packed_size;
+        zs_.next_out = reinterpret_cast<Bytef*>(raw_.data());
+        zs_.avail_out = raw_size;
+        int res = inflate(&zs_, Z_FINISH);
+        VERIFY_MSG(res == Z_STREAM_END && zs_.avail_out == 0, "Failed to inflate block: " << res);
+    }
+    VERIFY_MSG(is_, "Truncated compressed block");
+
+    setg(raw_.data(), raw_.data(), raw_.data() + raw_size);
+    return true;
+}
+
+BlockDecompressingStreamBuf::int_type BlockDecompressingStreamBuf::underflow() {
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+
+    if (!LoadBlock())
+        return traits_type::eof();
+
+    return traits_type::to_int_type(*gptr());
+}
+
+BlockDecompressingStreamBuf::BlockDecompressingStreamBuf(std::istream &is)
+        : is_(is), raw_(BLOCK_SIZE), packed_(BLOCK_SIZE) {
+    memset(&zs_, 0, sizeof(zs_));
+    int res = inflateInit2(&zs_, -15);
+    VERIFY_MSG(res == Z_OK, "Failed to initialize inflate: " << res);
+
+    setg(raw_.data(), raw_.data(), raw_.data());
+}
+
+BlockDecompressingStreamBuf::~BlockDecompressingStreamBuf() {
+    inflateEnd(&zs_);
+}
+
+void BlockDecompressingStreamBuf::seek(uint64_t virtual_offset) {
+    is_.clear();
+    is_.seekg(std::streamoff(virtual_offset >> 16));
+    if (!LoadBlock()) {
+        // Nothing to read past the last block
+        setg(raw_.data(), raw_.data(), raw_.data());
+        return;
+    }
+
+    size_t in_block = virtual_offset & (BLOCK_SIZE - 1);
+    VERIFY(eback() + in_block <= egptr());
+    setg(eback(), eback() + in_block, egptr());
+}
+
+}
@@ -0,0 +1,71 @@
+//***************************************************************************
+//* Copyright (c) 2019 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include <zlib.h>
+
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+#include <cstdint>
+
+namespace io {
+
+// Stream of independently deflated blocks of at most BLOCK_SIZE bytes each.
+// Positions inside such stream are addressed by virtual offsets (like in BGZF):
+// file offset of the block in the upper 48 bits and offset inside the unpacked
+// block in the lower 16 bits, so reading could be started at any of them.
+namespace block_compression {
+
+static constexpr size_t BLOCK_SIZE = 1 << 16;
+
+inline uint64_t VirtualOffset(uint64_t block_pos, size_t in_block) {
+    return (block_pos << 16) | in_block;
+}
+
+}
+
+class BlockCompressingStreamBuf : public std::streambuf {
+    std::ostream &os_;
+    uint64_t block_pos_;
+    std::vector<char> raw_, packed_;
+    z_stream zs_;
+
+    bool FlushBlock();
+
+protected:
+    int_type overflow(int_type c) override;
+    int sync() override;
+
+public:
+    // Blocks are appended starting from the current position of os
+    BlockCompressingStreamBuf(std::ostream &os, int level = Z_BEST_SPEED);
+    ~BlockCompressingStreamBuf();
+
+    // Virtual offset of the next byte to be written
+    uint64_t tell();
+};
+
+class BlockDecompressingStreamBuf : public std::streambuf {
+    std::istream &is_;
+    std::vector<char> raw_, packed_;
+    z_stream zs_;
+
+    bool LoadBlock();
+
+protected:
+    int_type underflow() override;
+
+public:
+    BlockDecompressingStreamBuf(std::istream &is);
+    ~BlockDecompressingStreamBuf();
+
+    void seek(uint64_t virtual_offset);
+};
+
+}
@@ -0,0 +1,263 @@
+//***************************************************************************
+//* Copyright (c) 2019 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#include "block_input.hpp"
+
+#include "utils/parallel/openmp_wrapper.h"
+#include "utils/verify.hpp"
+
+#include <zlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace io {
+
+namespace {
+
+const size_t INPUT_BLOCK_SIZE = 1 << 22;
+// Number of BGZF members inflated at once by every thread
+const size_t BGZF_MEMBERS_PER_THREAD = 16;
+
+// Fixed part of the gzip header, followed by the extra field of XLEN bytes if FEXTRA flag is set
+const size_t GZIP_HEADER_SIZE = 12;
+const uint8_t GZIP_FEXTRA = 4;
+// Header with the only extra subfield 'BC' holding the member size
+const size_t BGZF_HEADER_SIZE = 18;
+// CRC32 and ISIZE
+const size_t GZIP_FOOTER_SIZE = 8;
+
+size_t ReadFully(int fd, char *buffer, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t res = ::read(fd, buffer + total, size - total);
+        if (res < 0 && errno == EINTR)
+            continue;
+        VERIFY_MSG(res >= 0, "Failed to read input: " << strerror(errno));
+        if (res == 0)
+            break;
+        total += size_t(res);
+    }
+    return total;
+}
+
+uint16_t LoadLE16(const char *p) {
+    return uint16_t(uint8_t(p[0]) | (uint8_t(p[1]) << 8));
+}
+
+uint32_t LoadLE32(const char *p) {
+    return uint32_t(LoadLE16(p)) | (uint32_t(LoadLE16(p + 2)) << 16);
+}
+
+bool IsGzip(const std::vector<char> &header) {
+    return header.size() >= GZIP_HEADER_SIZE &&
+           uint8_t(header[0]) == 0x1f && uint8_t(header[1]) == 0x8b && header[2] == Z_DEFLATED;
+}
+
+bool IsBgzf(const std::vector<char> &header) {
+    return IsGzip(header) && header.size() >= BGZF_HEADER_SIZE &&
+           (header[3] & GZIP_FEXTRA) && LoadLE16(&header[10]) == 6 &&
+           header[12] == 'B' && header[13] == 'C' && LoadLE16(&header[14]) == 2;
+}
+
+// File descriptor read with plain read() calls. Bytes looked ahead for the format detection go first.
+class RawFile {
+    int fd_;
+    std::vector<char> prefix_;
+    size_t prefix_pos_;
+
+public:
+    RawFile(int fd, std::vector<char> prefix)
+            : fd_(fd), prefix_(std::move(prefix)), prefix_pos_(0) {}
+
+    RawFile(const RawFile &) = delete;
+    RawFile &operator=(const RawFile &) = delete;
+
+    ~RawFile() {
+        ::close(fd_);
+    }
+
+    size_t Read(char *buffer, size_t size) {
+        size_t from_prefix = std::min(size, prefix_.size() - prefix_pos_);
+        memcpy(buffer, prefix_.data() + prefix_pos_, from_prefix);
+        prefix_pos_ += from_prefix;
+        return from_prefix + ReadFully(fd_, buffer + from_prefix, size - from_prefix);
+    }
+};
+
+class PlainInput : public BlockInput {
+    RawFile file_;
+
+public:
+    PlainInput(int fd, std::vector<char> prefix)
+            : file_(fd, std::move(prefix)) {}
+
+    size_t Read(char *buffer, size_t size) override {
+        return file_.Read(buffer, size);
+    }
+};
+
+class GzipInput : public BlockInput {
+    RawFile file_;
+    std::vector<char> packed_;
+    z_stream zs_;
+    bool member_end_;
+    bool finished_;
+
+public:
+    GzipInput(int fd, std::vector<char> prefix)
+            : file_(fd, std::move(prefix)), packed_(INPUT_BLOCK_SIZE),
+              member_end_(false), finished_(false) {
+        memset(&zs_, 0, sizeof(zs_));
+        int res = inflateInit2(&zs_, 15 + 16);
+        VERIFY_MSG(res == Z_OK, "Failed to initialize inflate: " << res);
+    }
+
+    ~GzipInput() {
+        inflateEnd(&zs_);
+    }
+
+    size_t Read(char *buffer, size_t size) override {
+        size = std::min(size, size_t(std::numeric_limits<uInt>::max()));
+        zs_.next_out = reinterpret_cast<Bytef*>(buffer);
+        zs_.avail_out = uInt(size);
+        while (zs_.avail_out && !finished_) {
+            if (!zs_.avail_in) {
+                size_t packed_size = file_.Read(packed_.data(), packed_.size());
+                if (!packed_size) {
+                    finished_ = true;
+                    break;
+                }
+                zs_.next_in = reinterpret_cast<Bytef*>(packed_.data());
+                zs_.avail_in = uInt(packed_size);
+            }
+            if (member_end_) {
+                // Members are inflated one after another, trailing garbage is ignored as gzread does
+                if (zs_.next_in[0] != 0x1f) {
+                    finished_ = true;
+                    break;
+                }
+                inflateReset(&zs_);
+                member_end_ = false;
+            }
+            int res = inflate(&zs_, Z_NO_FLUSH);
+            if (res == Z_STREAM_END)
+                member_end_ = true;
+            else
+                VERIFY_MSG(res == Z_OK || res == Z_BUF_ERROR, "Corrupted gzip input, inflate returned " << res);
+        }
+        return size - zs_.avail_out;
+    }
+};
+
+class BgzfInput : public BlockInput {
+    RawFile file_;
+    std::vector<std::vector<char>> packed_, unpacked_;
+    size_t member_cnt_;
+    size_t member_, member_pos_;
+
+    // Returns false at the end of file
+    bool ReadMember(std::vector<char> &member) {
+        member.resize(BGZF_HEADER_SIZE);
+        size_t header_size = file_.Read(member.data(), BGZF_HEADER_SIZE);
+        if (!header_size)
+            return false;
+        VERIFY_MSG(header_size == BGZF_HEADER_SIZE && IsBgzf(member), "Corrupted BGZF input");
+
+        size_t member_size = size_t(LoadLE16(&member[16])) + 1;
+        VERIFY_MSG(member_size >= BGZF_HEADER_SIZE + GZIP_FOOTER_SIZE, "Corrupted BGZF input");
+        member.resize(member_size);
+        size_t rest = member_size - BGZF_HEADER_SIZE;
+        VERIFY_MSG(file_.Read(member.data() + BGZF_HEADER_SIZE, rest) == rest, "Truncated BGZF input");
+        return true;
+    }
+
+    static void Inflate(const std::vector<char> &member, std::vector<char> &unpacked) {
+        const char *footer = member.data() + member.size() - GZIP_FOOTER_SIZE;
+        uint32_t crc = LoadLE32(footer);
+        unpacked.resize(LoadLE32(footer + 4));
+
+        z_stream zs;
+        memset(&zs, 0, sizeof(zs));
+        // Raw deflate, the header is already parsed
+        int res = inflateInit2(&zs, -15);
+        VERIFY_MSG(res == Z_OK, "Failed to initialize inflate: " << res);
+        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(member.data() + BGZF_HEADER_SIZE));
+        zs.avail_in = uInt(member.size() - BGZF_HEADER_SIZE - GZIP_FOOTER_SIZE);
+        zs.next_out = reinterpret_cast<Bytef*>(unpacked.data());
+        zs.avail_out = uInt(unpacked.size());
+        res = inflate(&zs, Z_FINISH);
+        inflateEnd(&zs);
+
+        VERIFY_MSG(res == Z_STREAM_END && zs.avail_out == 0, "Corrupted BGZF member, inflate returned " << res);
+        VERIFY_MSG(crc == crc32(0, reinterpret_cast<const Bytef*>(unpacked.data()), uInt(unpacked.size())),
+                   "CRC mismatch in BGZF member");
+    }
+
+    bool LoadBatch() {
+        member_cnt_ = 0;
+        while (member_cnt_ < packed_.size() && ReadMember(packed_[member_cnt_]))
+            member_cnt_ += 1;
+
+#       pragma omp parallel for schedule(dynamic)
+        for (size_t i = 0; i < member_cnt_; ++i)
+            Inflate(packed_[i], unpacked_[i]);
+
+        member_ = member_pos_ = 0;
+        return member_cnt_ > 0;
+    }
+
+public:
+    BgzfInput(int fd, std::vector<char> prefix)
+            : file_(fd, std::move(prefix)),
+              packed_(BGZF_MEMBERS_PER_THREAD * omp_get_max_threads()),
+              unpacked_(packed_.size()),
+              member_cnt_(0), member_(0), member_pos_(0) {}
+
+    size_t Read(char *buffer, size_t size) override {
+        size_t total = 0;
+        while (total < size) {
+            if (member_ == member_cnt_ && !LoadBatch())
+                break;
+
+            const auto &unpacked = unpacked_[member_];
+            size_t cnt = std::min(size - total, unpacked.size() - member_pos_);
+            memcpy(buffer + total, unpacked.data() + member_pos_, cnt);
+            total += cnt;
+            member_pos_ += cnt;
+            if (member_pos_ == unpacked.size()) {
+                member_ += 1;
+                member_pos_ = 0;
+            }
+        }
+        return total;
+    }
+};
+
+}
+
+std::unique_ptr<BlockInput> OpenBlockInput(const std::string &filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    std::vector<char> header(BGZF_HEADER_SIZE);
+    header.resize(ReadFully(fd, header.data(), header.size()));
+
+    if (IsBgzf(header))
+        return std::unique_ptr<BlockInput>(new BgzfInput(fd, std::move(header)));
+    if (IsGzip(header))
+        return std::unique_ptr<BlockInput>(new GzipInput(fd, std::move(header)));
+    return std::unique_ptr<BlockInput>(new PlainInput(fd, std::move(header)));
+}
+
+}
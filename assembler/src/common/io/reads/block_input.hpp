@@ -0,0 +1,29 @@
+//***************************************************************************
+//* Copyright (c) 2019 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace io {
+
+// Source of the raw (decompressed) bytes of a reads file, read in large blocks.
+class BlockInput {
+public:
+    virtual ~BlockInput() {}
+
+    // Fills up to size bytes of the buffer, returns the number of bytes filled, zero at the end of input
+    virtual size_t Read(char *buffer, size_t size) = 0;
+};
+
+// Plain files are read as is, gzip ones (possibly multi-member) are inflated on the fly.
+// BGZF files, consisting of gzip members with sizes stored in their headers, are inflated
+// in batches of members in parallel.
+// Returns nullptr if the file cannot be opened.
+std::unique_ptr<BlockInput> OpenBlockInput(const std::string &filename);
+
+}
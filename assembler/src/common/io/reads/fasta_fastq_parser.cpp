@@ -0,0 +1,126 @@
+//***************************************************************************
+//* Copyright (c) 2019 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#include "fasta_fastq_parser.hpp"
+
+#include <cstring>
+
+namespace io {
+
+static const size_t PARSER_BLOCK_SIZE = 1 << 22;
+
+void FastaFastqParser::open() {
+    input_ = OpenBlockInput(filename_);
+    if (!input_) {
+        is_open_ = false;
+        return;
+    }
+    buffer_.resize(PARSER_BLOCK_SIZE);
+    begin_ = end_ = 0;
+    input_end_ = false;
+    eof_ = false;
+    is_open_ = true;
+    ReadAhead();
+}
+
+void FastaFastqParser::Refill() {
+    size_t rest = end_ - begin_;
+    memmove(buffer_.data(), buffer_.data() + begin_, rest);
+    begin_ = 0;
+    end_ = rest;
+    // A line longer than the whole buffer
+    if (end_ == buffer_.size())
+        buffer_.resize(2 * buffer_.size());
+
+    size_t cnt = input_->Read(buffer_.data() + end_, buffer_.size() - end_);
+    if (!cnt)
+        input_end_ = true;
+    end_ += cnt;
+}
+
+bool FastaFastqParser::NextLine(const char *&line, size_t &size) {
+    // Offset of the unscanned part relative to begin_, survives refills
+    size_t scanned = 0;
+    const char *line_end;
+    for (;;) {
+        const char *start = buffer_.data() + begin_;
+        line_end = static_cast<const char*>(memchr(start + scanned, '\n', end_ - begin_ - scanned));
+        if (line_end) {
+            line = start;
+            size = line_end - start;
+            begin_ += size + 1;
+            break;
+        }
+        if (input_end_) {
+            if (begin_ == end_)
+                return false;
+            line = start;
+            size = end_ - begin_;
+            begin_ = end_;
+            break;
+        }
+        scanned = end_ - begin_;
+        Refill();
+    }
+    if (size && line[size - 1] == '\r')
+        size -= 1;
+    return true;
+}
+
+bool FastaFastqParser::PeekChar(char &c) {
+    while (begin_ == end_) {
+        if (input_end_)
+            return false;
+        Refill();
+    }
+    c = buffer_[begin_];
+    return true;
+}
+
+bool FastaFastqParser::ReadRecord(SingleRead &read) {
+    const char *line;
+    size_t size;
+    do {
+        if (!NextLine(line, size))
+            return false;
+    } while (!size || (line[0] != '>' && line[0] != '@'));
+
+    std::string name(line + 1, size - 1);
+    std::string seq;
+    char c;
+    while (PeekChar(c) && c != '>' && c != '+' && c != '@') {
+        NextLine(line, size);
+        size_t from = seq.size();
+        seq.append(line, size);
+        for (size_t i = from; i < seq.size(); ++i) {
+            if (seq[i] >= 'a' && seq[i] <= 'z')
+                seq[i] = char(seq[i] - 'a' + 'A');
+        }
+    }
+
+    if (!PeekChar(c) || c != '+') {
+        read = SingleRead(std::move(name), std::move(seq));
+        return true;
+    }
+
+    // Skip the '+' line
+    NextLine(line, size);
+    std::string qual;
+    qual.reserve(seq.size());
+    do {
+        if (!NextLine(line, size))
+            break;
+        qual.append(line, size);
+    } while (qual.size() < seq.size());
+    // Truncated quality string ends the input, as in FastaFastqGzParser
+    if (qual.size() != seq.size())
+        return false;
+
+    read = SingleRead(std::move(name), std::move(seq), std::move(qual), offset_type_);
+    return true;
+}
+
+}
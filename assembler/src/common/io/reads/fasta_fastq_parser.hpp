@@ -0,0 +1,86 @@
+//***************************************************************************
+//* Copyright (c) 2019 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include "single_read.hpp"
+#include "block_input.hpp"
+
+#include "io/reads/parser.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace io {
+
+/*
+ * FASTA / FASTQ parser reading the (possibly gzipped) file in large blocks.
+ * Lines are located with memchr, records are built directly from the block
+ * buffer. Accepts the same inputs as FastaFastqGzParser: multi-line records,
+ * CRLF line ends, lowercase nucleotides.
+ */
+class FastaFastqParser: public Parser {
+public:
+    FastaFastqParser(const std::string& filename, OffsetType offset_type = PhredOffset)
+            : Parser(filename, offset_type), begin_(0), end_(0), input_end_(true) {
+        open();
+    }
+
+    ~FastaFastqParser() {
+        close();
+    }
+
+    FastaFastqParser& operator>>(SingleRead& read) {
+        if (!is_open_ || eof_)
+            return *this;
+
+        read = std::move(next_);
+        ReadAhead();
+        return *this;
+    }
+
+    void close() {
+        if (!is_open_)
+            return;
+
+        input_.reset();
+        std::vector<char>().swap(buffer_);
+        is_open_ = false;
+        eof_ = true;
+    }
+
+private:
+    std::unique_ptr<BlockInput> input_;
+    std::vector<char> buffer_;
+    // Unparsed part of the buffer
+    size_t begin_, end_;
+    bool input_end_;
+    SingleRead next_;
+
+    void open();
+
+    void ReadAhead() {
+        if (!ReadRecord(next_))
+            eof_ = true;
+    }
+
+    // Moves the unparsed data to the buffer start and reads the next block after it
+    void Refill();
+
+    // Returns false at the end of input. The line is valid until the next call, line end is stripped.
+    bool NextLine(const char *&line, size_t &size);
+
+    // First character of the next line, false at the end of input
+    bool PeekChar(char &c);
+
+    bool ReadRecord(SingleRead &read);
+
+    FastaFastqParser(const FastaFastqParser& parser) = delete;
+    void operator=(const FastaFastqParser& parser) = delete;
+};
+
+}
@@ -144,14 +144,14 @@ public:
     }
 
     bool wait_dequeue(T &data) {
-        bool res = false;
-        do {
-            res = dequeue(data);
-            if (!res)
-                usleep(1);
-        } while (!res && !is_closed());
-
-        return res;
+        while (!dequeue(data)) {
+            // Elements enqueued right before closing should not be lost
+            if (closed_.load(std::memory_order_acquire))
+                return dequeue(data);
+            usleep(1);
+        }
+
+        return true;
     }
 
 private:
@@ -26,7 +26,7 @@
  */
 
 #include "single_read.hpp"
-#include "fasta_fastq_gz_parser.hpp"
+#include "fasta_fastq_parser.hpp"
 #include "parser.hpp"
 #include "sam/bam_parser.hpp"
 
@@ -68,7 +68,7 @@ Parser* SelectParser(const std::string& filename,
   if (ext == "bam")
       return new BAMParser(filename, offset_type);
 
-  return new FastaFastqGzParser(filename, offset_type);
+  return new FastaFastqParser(filename, offset_type);
   /*
   if ((ext == "fastq") || (ext == "fastq.gz") ||
       (ext == "fasta") || (ext == "fasta.gz") ||
@@ -12,6 +12,9 @@
 #include "utils/parallel/openmp_wrapper.h"
 
 #include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <sched.h>
 
 #pragma GCC diagnostic push
@@ -19,8 +22,21 @@
 #pragma clang diagnostic ignored "-Wunused-private-field"
 #endif
 namespace hammer {
+
+namespace impl {
+// Processors taking reads by reference do not need to own them, so the reads
+// could be recycled between calls
+template<class Op, class Read, class = void>
+struct takes_read_reference : std::false_type {};
+
+template<class Op, class Read>
+struct takes_read_reference<Op, Read,
+                            decltype(void(std::declval<Op&>()(std::declval<Read&>())))> : std::true_type {};
+}
+
 class ReadProcessor {
     static size_t constexpr cacheline_size = 64;
+    static size_t constexpr batch_size = 1024;
     typedef char cacheline_pad_t[cacheline_size];
 
     unsigned nthreads_;
@@ -31,8 +47,49 @@ class ReadProcessor {
     cacheline_pad_t pad2;
 
 private:
+    template<class ReadT>
+    struct ReadBatch {
+        std::vector<ReadT> reads;
+        size_t size;
+
+        ReadBatch() : reads(batch_size), size(0) {}
+    };
+
+    static unsigned RoundUpToPowerOfTwo(unsigned n) {
+        n -= 1;
+        n = (n >> 1) | n;
+        n = (n >> 2) | n;
+        n = (n >> 4) | n;
+        n = (n >> 8) | n;
+        n = (n >> 16) | n;
+        return n + 1;
+    }
+
+    static bool StopRequested(const bool &stop) {
+        bool res;
+#   pragma omp atomic read
+        res = stop;
+        return res;
+    }
+
     template<class Reader, class Op>
-    bool RunSingle(Reader &irs, Op &op) {
+    bool RunSingle(Reader &irs, Op &op, std::true_type) {
+        typename Reader::ReadT r;
+
+        while (!irs.eof()) {
+            irs >> r;
+            read_ += 1;
+
+            processed_ += 1;
+            if (op(r))
+                return true;
+        }
+
+        return false;
+    }
+
+    template<class Reader, class Op>
+    bool RunSingle(Reader &irs, Op &op, std::false_type) {
         using ReadPtr = std::unique_ptr<typename Reader::ReadT>;
 
         while (!irs.eof()) {
@@ -65,29 +122,75 @@ private:
         }
     }
 
-public:
-    ReadProcessor(unsigned nthreads)
-            : nthreads_(nthreads), read_(0), processed_(0) { }
+    // Reads are filled into the batches taken from the fixed pool and the
+    // whole batches are passed to workers, so no allocation happens per read
+    template<class Reader, class Op>
+    bool RunParallel(Reader &irs, Op &op, std::true_type) {
+        using Batch = ReadBatch<typename Reader::ReadT>;
 
-    size_t read() const { return read_; }
+        unsigned bufsize = RoundUpToPowerOfTwo(nthreads_);
 
-    size_t processed() const { return processed_; }
+        // Every batch is either being filled, queued or processed
+        std::vector<Batch> pool(2 * bufsize + nthreads_);
+        mpmc_bounded_queue<Batch*> in_queue(2 * bufsize),
+                free_queue(RoundUpToPowerOfTwo(unsigned(pool.size())));
+        for (Batch &batch : pool)
+            free_queue.enqueue(&batch);
+
+        bool stop = false;
+#   pragma omp parallel shared(in_queue, free_queue, irs, op, stop) num_threads(nthreads_)
+        {
+#     pragma omp master
+            {
+                while (!irs.eof()) {
+                    Batch *batch;
+                    while (!free_queue.dequeue(batch))
+                        sched_yield();
+
+                    for (batch->size = 0; batch->size < batch_size && !irs.eof(); ++batch->size)
+                        irs >> batch->reads[batch->size];
+#         pragma omp atomic
+                    read_ += batch->size;
+
+                    while (!in_queue.enqueue(batch))
+                        sched_yield();
+
+                    if (StopRequested(stop))
+                        break;
+                }
+
+                in_queue.close();
+            }
+
+            // Once the stop is requested, the rest of the reads (including
+            // the queued batches) are skipped and batches are just recycled
+            Batch *batch;
+            while (in_queue.wait_dequeue(batch)) {
+                size_t processed = 0;
+                while (processed < batch->size && !StopRequested(stop)) {
+                    if (op(batch->reads[processed++])) {
+#         pragma omp atomic write
+                        stop = true;
+                    }
+                }
+
+#       pragma omp atomic
+                processed_ += processed;
+
+                while (!free_queue.enqueue(batch))
+                    sched_yield();
+            }
+        }
+
+#   pragma omp flush(stop)
+        return stop;
+    }
 
     template<class Reader, class Op>
-    bool Run(Reader &irs, Op &op) {
+    bool RunParallel(Reader &irs, Op &op, std::false_type) {
         using ReadPtr = std::unique_ptr<typename Reader::ReadT>;
 
-        if (nthreads_ < 2)
-            return RunSingle(irs, op);
-
-        // Round nthreads to next power of two
-        unsigned bufsize = nthreads_ - 1;
-        bufsize = (bufsize >> 1) | bufsize;
-        bufsize = (bufsize >> 2) | bufsize;
-        bufsize = (bufsize >> 4) | bufsize;
-        bufsize = (bufsize >> 8) | bufsize;
-        bufsize = (bufsize >> 16) | bufsize;
-        bufsize += 1;
+        unsigned bufsize = RoundUpToPowerOfTwo(nthreads_);
 
         mpmc_bounded_queue<ReadPtr> in_queue(2 * bufsize);
 
@@ -105,8 +208,7 @@ public:
                     while (!in_queue.enqueue(std::move(r)))
                         sched_yield();
 
-#         pragma omp flush (stop)
-                    if (stop)
+                    if (StopRequested(stop))
                         break;
                 }
 
@@ -119,13 +221,16 @@ public:
                 if (!in_queue.wait_dequeue(r))
                     break;
 
+                // Queued reads are dropped after the stop
+                if (StopRequested(stop))
+                    continue;
+
 #       pragma omp atomic
                 processed_ += 1;
 
-                bool res = op(std::move(r));
-                if (res) {
-#         pragma omp atomic
-                    stop |= res;
+                if (op(std::move(r))) {
+#         pragma omp atomic write
+                    stop = true;
                 }
             }
         }
@@ -134,6 +239,27 @@ public:
         return stop;
     }
 
+public:
+    ReadProcessor(unsigned nthreads)
+            : nthreads_(nthreads), read_(0), processed_(0) { }
+
+    size_t read() const { return read_; }
+
+    size_t processed() const { return processed_; }
+
+    // Processors accepting (const) reference to read are run over the recycled
+    // read batches, ones accepting std::unique_ptr get every read allocated
+    template<class Reader, class Op>
+    bool Run(Reader &irs, Op &op) {
+        typedef std::integral_constant<bool,
+                impl::takes_read_reference<Op, typename Reader::ReadT>::value> by_reference;
+
+        if (nthreads_ < 2)
+            return RunSingle(irs, op, by_reference());
+
+        return RunParallel(irs, op, by_reference());
+    }
+
     template<class Reader, class Op, class Writer>
     void Run(Reader &irs, Op &op, Writer &writer) {
         using ReadPtr = std::unique_ptr<typename Reader::ReadT>;
@@ -143,14 +269,7 @@ public:
             return;
         }
 
-        // Round nthreads to next power of two
-        unsigned bufsize = nthreads_ - 1;
-        bufsize = (bufsize >> 1) | bufsize;
-        bufsize = (bufsize >> 2) | bufsize;
-        bufsize = (bufsize >> 4) | bufsize;
-        bufsize = (bufsize >> 8) | bufsize;
-        bufsize = (bufsize >> 16) | bufsize;
-        bufsize += 1;
+        unsigned bufsize = RoundUpToPowerOfTwo(nthreads_);
 
         mpmc_bounded_queue<ReadPtr> in_queue(bufsize), out_queue(2 * bufsize);
 #   pragma omp parallel shared(in_queue, out_queue, irs, op, writer) num_threads(nthreads_)
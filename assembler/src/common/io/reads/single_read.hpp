@@ -15,6 +15,7 @@
 #include "utils/stl_utils.hpp"
 
 #include <string>
+#include <cstring>
 
 namespace io {
 
@@ -45,26 +46,26 @@ public:
             name_(""), seq_(""), qual_(""), left_offset_(0), right_offset_(0), valid_(false) {
     }
 
-    SingleRead(const std::string &name, const std::string &seq,
-               const std::string &qual, OffsetType offset,
+    SingleRead(std::string name, std::string seq,
+               std::string qual, OffsetType offset,
                SequenceOffsetT left_offset = 0, SequenceOffsetT right_offset = 0) :
-            name_(name), seq_(seq), qual_(qual), left_offset_(left_offset), right_offset_(right_offset) {
+            name_(std::move(name)), seq_(std::move(seq)), qual_(std::move(qual)), left_offset_(left_offset), right_offset_(right_offset) {
         Init();
         for (size_t i = 0; i < qual_.size(); ++i) {
             qual_[i] = (char) (qual_[i] - offset);
         }
     }
 
-    SingleRead(const std::string &name, const std::string &seq,
-               const std::string &qual,
+    SingleRead(std::string name, std::string seq,
+               std::string qual,
                SequenceOffsetT left_offset = 0, SequenceOffsetT right_offset = 0) :
-            name_(name), seq_(seq), qual_(qual), left_offset_(left_offset), right_offset_(right_offset) {
+            name_(std::move(name)), seq_(std::move(seq)), qual_(std::move(qual)), left_offset_(left_offset), right_offset_(right_offset) {
         Init();
     }
 
-    SingleRead(const std::string &name, const std::string &seq,
+    SingleRead(std::string name, std::string seq,
                SequenceOffsetT left_offset = 0, SequenceOffsetT right_offset = 0) :
-            name_(name), seq_(seq), qual_(EmptyQuality(seq_)), left_offset_(left_offset),
+            name_(std::move(name)), seq_(std::move(seq)), qual_(EmptyQuality(seq_)), left_offset_(left_offset),
             right_offset_(right_offset) {
         Init();
     }
@@ -266,6 +267,15 @@ public:
         return !file.fail();
     }
 
+    const char *BinRead(const char *data, const char *end) {
+        data = seq_.BinRead(data, end);
+        VERIFY(size_t(end - data) >= sizeof(left_offset_) + sizeof(right_offset_));
+        memcpy(&left_offset_, data, sizeof(left_offset_));
+        data += sizeof(left_offset_);
+        memcpy(&right_offset_, data, sizeof(right_offset_));
+        return data + sizeof(right_offset_);
+    }
+
     bool BinWrite(std::ostream &file, bool rc = false) const {
         if (rc)
             (!seq_).BinWrite(file);
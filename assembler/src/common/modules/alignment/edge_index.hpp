@@ -29,6 +29,7 @@ public:
     typedef typename InnerIndex::KMer KMer;
     typedef typename InnerIndex::KMerIdx KMerIdx;
     typedef typename InnerIndex::KmerPos Value;
+    typedef typename InnerIndex::KeyWithHash KeyWithHash;
 
 private:
     InnerIndex inner_index_;
@@ -70,14 +71,34 @@ public:
         updater_.DeleteKmers(e);
     }
 
+    bool IsDeferrable() const override {
+        return true;
+    }
+
     bool contains(const KMer& kmer) const {
         VERIFY(this->IsAttached());
         return inner_index_.contains(inner_index_.ConstructKWH(kmer));
     }
 
+    KeyWithHash ConstructKWH(const KMer& kmer) const {
+        return inner_index_.ConstructKWH(kmer);
+    }
+
+    //Lookup hints, see PerfectHashMap
+    void prefetch(const KeyWithHash& kwh) const {
+        inner_index_.prefetch(kwh);
+    }
+
+    void prefetch_value(const KeyWithHash& kwh) const {
+        inner_index_.prefetch_value(kwh);
+    }
+
     const std::pair<EdgeId, size_t> get(const KMer& kmer) const {
+        return get(inner_index_.ConstructKWH(kmer));
+    }
+
+    const std::pair<EdgeId, size_t> get(const KeyWithHash& kwh) const {
         VERIFY(this->IsAttached());
-        auto kwh = inner_index_.ConstructKWH(kmer);
         if (!inner_index_.contains(kwh)) {
             return { EdgeId(), -1u };
         } else {
@@ -0,0 +1,156 @@
+//***************************************************************************
+//* Copyright (c) 2018 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include "assembly_graph/core/graph.hpp"
+#include "utils/parallel/openmp_wrapper.h"
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace sensitive_aligner {
+
+// Bounded concurrent cache of vertex-pair distances.
+// Set-associative table with CLOCK replacement inside each bucket. Every slot is
+// guarded by a sequence counter, so lookups never take locks: a reader that races
+// with a writer simply reports a miss. Writers never wait either, insertion into a
+// slot being updated by another thread is dropped.
+class VertexDistanceCache {
+    typedef debruijn_graph::VertexId VertexId;
+
+    static const size_t WAYS = 8;
+
+    struct Slot {
+        std::atomic<uint64_t> seq;
+        std::atomic<uint64_t> key;
+        std::atomic<uint64_t> value;
+        std::atomic<bool> referenced;
+
+        Slot() : seq(0), key(0), value(0), referenced(false) {}
+    };
+
+    struct Bucket {
+        Slot slots[WAYS];
+        std::atomic<unsigned> hand;
+
+        Bucket() : hand(0) {}
+    };
+
+    //Padded to avoid false sharing of counters between threads
+    struct ThreadStats {
+        size_t hits = 0;
+        size_t misses = 0;
+        char padding[64 - 2 * sizeof(size_t)];
+    };
+
+    std::unique_ptr<Bucket[]> buckets_;
+    size_t bucket_mask_;
+    std::vector<ThreadStats> stats_;
+
+    //Vertex ids start from a positive bias, so zero key marks an empty slot
+    static bool MakeKey(VertexId start, VertexId end, uint64_t &key) {
+        uint64_t start_id = start.int_id(), end_id = end.int_id();
+        if (start_id > std::numeric_limits<uint32_t>::max() || end_id > std::numeric_limits<uint32_t>::max())
+            return false;
+        key = (start_id << 32) | end_id;
+        return true;
+    }
+
+    Bucket &GetBucket(uint64_t key) const {
+        //Fibonacci hashing, high bits are the best mixed
+        uint64_t h = key * 0x9E3779B97F4A7C15ull;
+        return buckets_[(h >> 32) & bucket_mask_];
+    }
+
+    ThreadStats &thread_stats() {
+        return stats_[omp_get_thread_num() % stats_.size()];
+    }
+
+    static bool Read(const Slot &slot, uint64_t key, size_t &value) {
+        uint64_t seq = slot.seq.load(std::memory_order_acquire);
+        if (seq & 1)
+            return false;
+        uint64_t slot_key = slot.key.load(std::memory_order_relaxed);
+        uint64_t slot_value = slot.value.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != seq || slot_key != key)
+            return false;
+        value = slot_value;
+        return true;
+    }
+
+public:
+    //Capacity is rounded up to a power of two number of buckets
+    explicit VertexDistanceCache(size_t capacity, size_t nthreads = omp_get_max_threads()) :
+            stats_(std::max(nthreads, size_t(1))) {
+        size_t bucket_cnt = 1;
+        while (bucket_cnt * WAYS < capacity)
+            bucket_cnt <<= 1;
+        buckets_.reset(new Bucket[bucket_cnt]);
+        bucket_mask_ = bucket_cnt - 1;
+    }
+
+    bool Find(VertexId start, VertexId end, size_t &distance) {
+        uint64_t key;
+        if (MakeKey(start, end, key)) {
+            for (Slot &slot : GetBucket(key).slots) {
+                if (Read(slot, key, distance)) {
+                    if (!slot.referenced.load(std::memory_order_relaxed))
+                        slot.referenced.store(true, std::memory_order_relaxed);
+                    thread_stats().hits += 1;
+                    return true;
+                }
+            }
+        }
+        thread_stats().misses += 1;
+        return false;
+    }
+
+    void Insert(VertexId start, VertexId end, size_t distance) {
+        uint64_t key;
+        if (!MakeKey(start, end, key))
+            return;
+
+        Bucket &bucket = GetBucket(key);
+        //CLOCK: give a second chance to recently used slots
+        Slot *victim = nullptr;
+        for (size_t i = 0; i < 2 * WAYS; ++i) {
+            Slot &slot = bucket.slots[bucket.hand.fetch_add(1, std::memory_order_relaxed) % WAYS];
+            if (!slot.referenced.exchange(false, std::memory_order_relaxed)) {
+                victim = &slot;
+                break;
+            }
+        }
+        if (!victim)
+            return;
+
+        uint64_t seq = victim->seq.load(std::memory_order_relaxed);
+        if ((seq & 1) || !victim->seq.compare_exchange_strong(seq, seq + 1, std::memory_order_acq_rel))
+            return;
+        victim->key.store(key, std::memory_order_relaxed);
+        victim->value.store(distance, std::memory_order_relaxed);
+        victim->seq.store(seq + 2, std::memory_order_release);
+    }
+
+    size_t hits() const {
+        size_t res = 0;
+        for (const auto &stats : stats_)
+            res += stats.hits;
+        return res;
+    }
+
+    size_t misses() const {
+        size_t res = 0;
+        for (const auto &stats : stats_)
+            res += stats.misses;
+        return res;
+    }
+};
+
+}
@@ -43,6 +43,10 @@ class GAligner {
            const alignment::BWAIndex::AlignmentMode &mode)
     : pac_index_(g, pb_config, mode), g_(g), pb_config_(pb_config), restore_ends_(false), gap_filler_(g, GAlignerConfig(pb_config, mode)) {}
 
+  const PacBioMappingIndex &pac_index() const {
+    return pac_index_;
+  }
+
 
  private:
   PacBioMappingIndex pac_index_;
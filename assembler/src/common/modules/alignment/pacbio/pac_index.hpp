@@ -13,6 +13,7 @@
 
 #include "assembly_graph/index/edge_multi_index.hpp"
 #include "assembly_graph/graph_support/basic_vertex_conditions.hpp"
+#include "assembly_graph/dijkstra/bidirectional_dijkstra.hpp"
 
 #include "modules/alignment/edge_index_refiller.hpp"
 #include "modules/alignment/bwa_sequence_mapper.hpp"
@@ -20,6 +21,7 @@
 
 #include "modules/alignment/pacbio/pacbio_read_structures.hpp"
 #include "modules/alignment/pacbio/gap_filler.hpp"
+#include "modules/alignment/pacbio/distance_cache.hpp"
 
 namespace sensitive_aligner {
 
@@ -39,6 +41,8 @@ class PacBioMappingIndex {
                        debruijn_graph::config::pacbio_processor pb_config,
                        alignment::BWAIndex::AlignmentMode mode)
         : g_(g),
+          distance_cache_(DISTANCE_CACHE_SIZE),
+          dijkstra_workspaces_(omp_get_max_threads()),
           pb_config_(pb_config),
           bwa_mapper_(g, mode) {
         DEBUG("PB Mapping Index construction started");
@@ -79,6 +83,10 @@ class PacBioMappingIndex {
         return res;
     }
 
+    const VertexDistanceCache &distance_cache() const {
+        return distance_cache_;
+    }
+
   private:
     DECL_LOGGER("PacIndex")
 
@@ -86,8 +94,10 @@ class PacBioMappingIndex {
 
     static const size_t SHORT_SPURIOUS_LENGTH = 500;
     static const int SIMILARITY_LENGTH = 200;
-    //presumably separate class for this and GetDistance
-    mutable std::map<std::pair<VertexId, VertexId>, size_t> distance_cashed_;
+    static const size_t DISTANCE_CACHE_SIZE = 1 << 20;
+    mutable VertexDistanceCache distance_cache_;
+    //one per thread, reused by all distance queries
+    mutable std::vector<omnigraph::DijkstraWorkspace<Graph>> dijkstra_workspaces_;
     size_t read_count_;
     debruijn_graph::config::pacbio_processor pb_config_;
 
@@ -356,33 +366,20 @@ class PacBioMappingIndex {
     size_t GetDistance(VertexId start_v, VertexId end_v,
                        bool update_cache = true) const {
         size_t result = size_t(-1);
-        auto vertex_pair = std::make_pair(start_v, end_v);
-        bool not_found;
-        auto distance_it = distance_cashed_.begin();
-        //FIXME should permit multiple readers
-        #pragma omp critical(pac_index)
-        {
-            distance_it = distance_cashed_.find(vertex_pair);
-            not_found = (distance_it == distance_cashed_.end());
-        }
-        if (not_found) {
-            omnigraph::DijkstraHelper<debruijn_graph::Graph>::BoundedDijkstra dijkstra(
-                omnigraph::DijkstraHelper<debruijn_graph::Graph>::CreateBoundedDijkstra(g_,
-                        pb_config_.max_path_in_dijkstra,
-                        pb_config_.max_vertex_in_dijkstra));
-            dijkstra.Run(start_v);
-            if (dijkstra.DistanceCounted(end_v)) {
-                result = dijkstra.GetDistance(end_v);
-            }
-            if (update_cache) {
-                #pragma omp critical(pac_index)
-                distance_cashed_.insert({vertex_pair, result});
-            }
-        } else {
+        if (distance_cache_.Find(start_v, end_v, result)) {
             TRACE("taking from cashed");
-            result = distance_it->second;
+            return result;
         }
 
+        size_t thread_id = omp_get_thread_num();
+        VERIFY(thread_id < dijkstra_workspaces_.size());
+        omnigraph::BidirectionalDijkstra<Graph> dijkstra(g_,
+                                                         pb_config_.max_path_in_dijkstra,
+                                                         pb_config_.max_vertex_in_dijkstra);
+        result = dijkstra.Distance(start_v, end_v, dijkstra_workspaces_[thread_id]);
+        if (update_cache)
+            distance_cache_.Insert(start_v, end_v, result);
+
         return result;
     }
 
@@ -296,9 +296,81 @@ class BasicSequenceMapper: public AbstractSequenceMapper<Graph> {
   size_t k_;
   bool optimization_on_;
 
-  bool FindKmer(const Kmer &kmer, size_t kmer_pos, std::vector<EdgeId> &passed,
+  typedef typename Index::KeyWithHash KeyWithHash;
+
+  //How many k-mers ahead the index is prefetched while the mapping can not be threaded
+  static const size_t PREFETCH_DISTANCE = 8;
+
+  //Index key of the k-mer after the substitution
+  struct KmerLookup {
+    KeyWithHash kwh;
+    bool substituted;
+  };
+
+  //Lookups go to random places of the index, so while the mapping can not be threaded
+  //they are pipelined: PREFETCH_DISTANCE positions ahead a k-mer is substituted and the
+  //hash function data of the result is prefetched, half way its value slot is prefetched,
+  //and the lookup itself is done when the k-mer is processed
+  class LookupPipeline {
+    const BasicSequenceMapper &mapper_;
+    const Sequence &sequence_;
+    size_t kmer_cnt_;
+    //lookup of the k-mer at position pos is kept at pos % PREFETCH_DISTANCE
+    std::vector<KmerLookup> staged_;
+    //k-mers from the last restart up to end_ are staged, last_ is the one at end_ - 1
+    size_t end_;
+    Kmer last_;
+
+    void Stage(const Kmer &kmer) {
+      const auto &index = mapper_.index_;
+      const auto &kmer_mapper = mapper_.kmer_mapper_;
+      bool substituted = kmer_mapper.CanSubstitute(kmer);
+      KmerLookup lookup{index.ConstructKWH(substituted ? kmer_mapper.Substitute(kmer) : kmer), substituted};
+      index.prefetch(lookup.kwh);
+      if (staged_.empty())
+        staged_.assign(PREFETCH_DISTANCE, lookup);
+      else
+        staged_[end_ % PREFETCH_DISTANCE] = lookup;
+      last_ = kmer;
+      end_ += 1;
+    }
+
+    void Restart(const Kmer &kmer, size_t pos) {
+      end_ = pos;
+      Stage(kmer);
+    }
+
+   public:
+    LookupPipeline(const BasicSequenceMapper &mapper, const Sequence &sequence)
+        : mapper_(mapper), sequence_(sequence),
+          kmer_cnt_(sequence.size() - mapper.k_ + 1),
+          end_(0), last_(sequence.start<Kmer>(mapper.k_)) {}
+
+    //Is called for consecutive k-mers while the mapping is not threaded
+    void Advance(const Kmer &kmer, size_t pos) {
+      if (pos >= end_)
+        Restart(kmer, pos);
+
+      size_t last_pos = std::min(pos + PREFETCH_DISTANCE, kmer_cnt_);
+      while (end_ < last_pos)
+        Stage(last_ << sequence_[end_ + mapper_.k_ - 1]);
+
+      size_t half_pos = pos + PREFETCH_DISTANCE / 2;
+      if (half_pos < end_)
+        mapper_.index_.prefetch_value(staged_[half_pos % PREFETCH_DISTANCE].kwh);
+    }
+
+    const KmerLookup &Get(const Kmer &kmer, size_t pos) {
+      if (pos >= end_)
+        Restart(kmer, pos);
+
+      return staged_[pos % PREFETCH_DISTANCE];
+    }
+  };
+
+  bool FindKmer(const KeyWithHash &kwh, size_t kmer_pos, std::vector<EdgeId> &passed,
                 RangeMappings& range_mappings) const {
-    const auto& position = index_.get(kmer);
+    const auto& position = index_.get(kwh);
     if (position.second == -1u)
         return false;
     
@@ -322,7 +394,7 @@ class BasicSequenceMapper: public AbstractSequenceMapper<Graph> {
     EdgeId last_edge = passed.back();
     size_t end_pos = range_mappings.back().mapped_range.end_pos;
     if (end_pos < g_.length(last_edge)) {
-      if (g_.EdgeNucls(last_edge)[end_pos + k_ - 1] == kmer[k_ - 1]) {
+      if (g_.EdgeNuclsView(last_edge)[end_pos + k_ - 1] == kmer[k_ - 1]) {
         range_mappings.back().initial_range.end_pos++;
         range_mappings.back().mapped_range.end_pos++;
         return true;
@@ -336,7 +408,7 @@ class BasicSequenceMapper: public AbstractSequenceMapper<Graph> {
 
       for (auto I = g_.out_begin(v), E = g_.out_end(v); I != E; ++I) {
         EdgeId edge = *I;
-        if (g_.EdgeNucls(edge)[k_ - 1] == kmer[k_ - 1]) {
+        if (g_.EdgeNuclsView(edge)[k_ - 1] == kmer[k_ - 1]) {
           passed.push_back(edge);
           range_mappings.push_back(
               MappingRange(Range(kmer_pos, kmer_pos + 1),
@@ -348,23 +420,25 @@ class BasicSequenceMapper: public AbstractSequenceMapper<Graph> {
     return false;
   }
 
-  bool ProcessKmer(const Kmer &kmer, size_t kmer_pos, std::vector<EdgeId> &passed_edges,
+  bool ProcessKmer(const Kmer &kmer, size_t kmer_pos, LookupPipeline &lookups,
+                   std::vector<EdgeId> &passed_edges,
                    RangeMappings& range_mapping, bool try_thread) const {
     if (try_thread) {
         if (!TryThread(kmer, kmer_pos, passed_edges, range_mapping)) {
-            FindKmer(kmer_mapper_.Substitute(kmer), kmer_pos, passed_edges, range_mapping);
+            FindKmer(lookups.Get(kmer, kmer_pos).kwh, kmer_pos, passed_edges, range_mapping);
             return false;
         }
 
         return true;
     }
 
-    if (kmer_mapper_.CanSubstitute(kmer)) {
-        FindKmer(kmer_mapper_.Substitute(kmer), kmer_pos, passed_edges, range_mapping);
+    const KmerLookup &lookup = lookups.Get(kmer, kmer_pos);
+    if (lookup.substituted) {
+        FindKmer(lookup.kwh, kmer_pos, passed_edges, range_mapping);
         return false;
     }
 
-    return FindKmer(kmer, kmer_pos, passed_edges, range_mapping);
+    return FindKmer(lookup.kwh, kmer_pos, passed_edges, range_mapping);
   }
 
  public:
@@ -386,12 +460,16 @@ class BasicSequenceMapper: public AbstractSequenceMapper<Graph> {
     }
 
     Kmer kmer = sequence.start<Kmer>(k_);
+    LookupPipeline lookups(*this, sequence);
     bool try_thread = false;
-    try_thread = ProcessKmer(kmer, 0, passed_edges,
+    lookups.Advance(kmer, 0);
+    try_thread = ProcessKmer(kmer, 0, lookups, passed_edges,
                              range_mapping, try_thread);
     for (size_t i = k_; i < sequence.size(); ++i) {
       kmer <<= sequence[i];
-      try_thread = ProcessKmer(kmer, i - k_ + 1, passed_edges,
+      if (!try_thread)
+        lookups.Advance(kmer, i - k_ + 1);
+      try_thread = ProcessKmer(kmer, i - k_ + 1, lookups, passed_edges,
                                range_mapping, try_thread);
       if (only_simple && passed_edges.size() > 1)
         return MappingPath<EdgeId>();
@@ -161,7 +161,7 @@ void GenomeConsistenceChecker::CheckPathEnd(const BidirectionalPath &path) const
                     if (lib.is_mate_pair())
                         paired_lib = path_extend::MakeNewLib(gp_.g, lib, gp_.paired_indices[lib_index]);
                     else if (lib.type() == io::LibraryType::PairedEnd)
-                        paired_lib = path_extend::MakeNewLib(gp_.g, lib, gp_.clustered_indices[lib_index]);
+                        paired_lib = path_extend::MakeNewLib(gp_.g, lib, clustered_indices_[lib_index]);
                     ReportPathEndByPairedLib(paired_lib, current_edge);
                 } else if (lib.is_long_read_lib()) {
                     ReportPathEndByLongLib(long_reads_cov_map_[lib_index].GetCoveringPaths(current_edge), current_edge);
@@ -226,7 +226,7 @@ void GenomeConsistenceChecker::PrintMisassemblyInfo(EdgeId e1, EdgeId e2) const
             if (lib.is_mate_pair())
                 paired_lib = path_extend::MakeNewLib(gp_.g, lib, gp_.paired_indices[lib_index]);
             else if (lib.type() == io::LibraryType::PairedEnd)
-                paired_lib = path_extend::MakeNewLib(gp_.g, lib, gp_.clustered_indices[lib_index]);
+                paired_lib = path_extend::MakeNewLib(gp_.g, lib, clustered_indices_[lib_index]);
             INFO("for lib " << lib_index << " IS" << paired_lib->GetIS());
             INFO("Misassembly weight regardless of dists: " << paired_lib->CountPairedInfo(e1, e2, -1000000, 1000000));
             INFO("Next weight " << paired_lib->CountPairedInfo(e1, true_next, -1000000, 1000000));
@@ -142,6 +142,7 @@ class GenomeConsistenceChecker {
     const size_t unresolvable_len_;
 
     const ScaffoldingUniqueEdgeStorage &storage_;
+    const std::vector<path_extend::FrozenPairedInfoIndex> &clustered_indices_;
     const std::vector<path_extend::GraphCoverageMap> &long_reads_cov_map_;
     static const size_t SIGNIFICANT_LENGTH_LOWER_LIMIT = 10000;
     GenomeInfo genome_info_;
@@ -202,6 +203,7 @@ public:
                              double relative_max_gap /*= 0.2*/,
                              size_t unresolvable_len,
                              const ScaffoldingUniqueEdgeStorage &storage,
+                             const std::vector<path_extend::FrozenPairedInfoIndex> &clustered_indices,
                              const std::vector<path_extend::GraphCoverageMap> &long_reads_cov_map,
                              const io::DataSet<config::LibraryData> reads) :
             gp_(gp),
@@ -209,6 +211,7 @@ public:
             relative_max_gap_(relative_max_gap),
             unresolvable_len_(unresolvable_len),
             storage_(storage),
+            clustered_indices_(clustered_indices),
             long_reads_cov_map_(long_reads_cov_map),
             reads_(reads) {
         //Fixme call outside
@@ -27,6 +27,8 @@ class LoopTraverser {
     const size_t long_edge_limit_;
     const size_t component_size_limit_;
     const size_t shortest_path_limit_;
+    // Optional, shortest paths are searched over it while it is up to date
+    const omnigraph::CompactGraphLayout<Graph> *layout_;
     static const size_t DIJKSTRA_LIMIT = 3000;
     static const size_t BASIC_N_CNT = 100;
 
@@ -139,11 +141,7 @@ class LoopTraverser {
             VertexId first_vertex = g_.EdgeStart(end_path.Front());
 
             if (first_vertex != last_vertex) {
-                auto dijkstra = DijkstraHelper<Graph>::CreateBoundedDijkstra(g_, shortest_path_limit_,
-                                                                             DIJKSTRA_LIMIT,
-                                                                             true /* collect traceback */);
-                dijkstra.Run(last_vertex);
-                auto shortest_path = dijkstra.GetShortestPathTo(first_vertex);
+                auto shortest_path = ShortestPath(last_vertex, first_vertex);
 
                 if (shortest_path.empty()) {
                     DEBUG("Failed to find closing path");
@@ -166,6 +164,22 @@ class LoopTraverser {
         return true;
     }
 
+    std::vector<EdgeId> ShortestPath(VertexId from, VertexId to) const {
+        if (layout_ && !layout_->stale()) {
+            auto dijkstra = DijkstraHelper<Graph>::CreateCompactBoundedDijkstra(g_, *layout_, shortest_path_limit_,
+                                                                                DIJKSTRA_LIMIT,
+                                                                                true /* collect traceback */);
+            dijkstra.Run(from);
+            return dijkstra.GetShortestPathTo(to);
+        }
+
+        auto dijkstra = DijkstraHelper<Graph>::CreateBoundedDijkstra(g_, shortest_path_limit_,
+                                                                     DIJKSTRA_LIMIT,
+                                                                     true /* collect traceback */);
+        dijkstra.Run(from);
+        return dijkstra.GetShortestPathTo(to);
+    }
+
     bool ContainsLongEdges(const GraphComponent<Graph>& component) const {
         for (auto e : component.edges())
             if (g_.length(e) > long_edge_limit_)
@@ -176,11 +190,13 @@ class LoopTraverser {
 public:
     LoopTraverser(const Graph& g, GraphCoverageMap& coverage_map,
                   size_t long_edge_limit, size_t component_size_limit,
-                  size_t shortest_path_limit) :
+                  size_t shortest_path_limit,
+                  const omnigraph::CompactGraphLayout<Graph> *layout = nullptr) :
             g_(g), cov_map_(coverage_map),
             long_edge_limit_(long_edge_limit),
             component_size_limit_(component_size_limit),
-            shortest_path_limit_(shortest_path_limit) {
+            shortest_path_limit_(shortest_path_limit),
+            layout_(layout) {
     }
 
     size_t TraverseAllLoops() {
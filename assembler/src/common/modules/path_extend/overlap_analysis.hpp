@@ -66,7 +66,8 @@ class SWOverlapAnalyzer {
         return match_cnt;
     }
 
-    OverlapInfo InnerAnalyze(const Sequence& s1, const Sequence& s2) const {
+    template<class Seq>
+    OverlapInfo InnerAnalyze(const Seq& s1, const Seq& s2) const {
         if (s1.size() == 0 || s2.size() == 0) {
             return OverlapInfo();
         }
@@ -92,7 +93,8 @@ public:
     }
 
 
-    OverlapInfo AnalyzeOverlap(const Sequence& s1, const Sequence& s2) const {
+    template<class Seq>
+    OverlapInfo AnalyzeOverlap(const Seq& s1, const Seq& s2) const {
         DEBUG("Analysis started");
         size_t start1 = flank_length_ > s1.size() ? 0 : s1.size() - flank_length_;
         size_t end2 = flank_length_ > s2.size() ? s2.size() : flank_length_;
@@ -113,7 +115,7 @@ public:
     template<class Graph>
     OverlapInfo AnalyzeOverlap(const Graph& g, EdgeId e1, EdgeId e2) const {
         DEBUG("Analyzing edges " << g.str(e1) << " and " << g.str(e2));
-        return AnalyzeOverlap(g.EdgeNucls(e1), g.EdgeNucls(e2));
+        return AnalyzeOverlap(g.EdgeNuclsView(e1), g.EdgeNuclsView(e2));
     }
 
 private:
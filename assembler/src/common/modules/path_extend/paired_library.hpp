@@ -16,6 +16,7 @@
 
 #include "pipeline/graph_pack.hpp"
 #include "paired_info/paired_info.hpp"
+#include "paired_info/frozen_paired_index.hpp"
 #include "ideal_pair_info.hpp"
 
 #include "math/xmath.h"
@@ -28,6 +29,52 @@ using debruijn_graph::EdgeId;
 using omnigraph::de::PairedInfoIndexT;
 using omnigraph::de::Point;
 
+typedef omnigraph::de::FrozenPairedInfoIndexT<Graph> FrozenPairedInfoIndex;
+
+/**
+ * Compact read-only forms of the clustered and scaffolding indices of all libraries,
+ * built once per repeat resolution run. Indices of the graph pack are frozen in place:
+ * the mutable storage of an index is released as soon as its frozen form is built,
+ * and is restored from it on destruction for the stages following repeat resolution.
+ */
+class FrozenPairedIndices {
+    typedef omnigraph::de::PairedInfoIndicesT<Graph> PairedIndices;
+
+    PairedIndices &clustered_indices_;
+    PairedIndices &scaffolding_indices_;
+
+    static void Freeze(PairedIndices &indices, std::vector<FrozenPairedInfoIndex> &frozen) {
+        frozen.reserve(indices.size());
+        for (auto &index : indices) {
+            frozen.emplace_back(index);
+            index.clear();
+        }
+    }
+
+    static void Thaw(std::vector<FrozenPairedInfoIndex> &frozen, PairedIndices &indices) {
+        for (size_t i = 0; i < frozen.size(); ++i) {
+            indices[i].Thaw(frozen[i]);
+            frozen[i].clear();
+        }
+    }
+
+public:
+    std::vector<FrozenPairedInfoIndex> clustered;
+    std::vector<FrozenPairedInfoIndex> scaffolding;
+
+    FrozenPairedIndices(debruijn_graph::conj_graph_pack &gp)
+            : clustered_indices_(gp.clustered_indices),
+              scaffolding_indices_(gp.scaffolding_indices) {
+        Freeze(clustered_indices_, clustered);
+        Freeze(scaffolding_indices_, scaffolding);
+    }
+
+    ~FrozenPairedIndices() {
+        Thaw(clustered, clustered_indices_);
+        Thaw(scaffolding, scaffolding_indices_);
+    }
+};
+
 class PairedInfoLibrary {
 public:
     PairedInfoLibrary(const Graph& g, size_t read_length, size_t is,
@@ -19,7 +19,12 @@
 #include "path_filter.hpp"
 #include "overlap_analysis.hpp"
 #include "assembly_graph/graph_support/scaff_supplementary.hpp"
+#include "assembly_graph/components/connected_component.hpp"
+#include "adt/concurrent_dsu.hpp"
+#include "utils/parallel/openmp_wrapper.h"
 #include <cmath>
+#include <functional>
+#include <limits>
 
 namespace path_extend {
 
@@ -482,7 +487,7 @@ class HammingGapAnalyzer: public GapAnalyzer {
 
     static constexpr double MIN_OVERLAP_COEFF = 0.05;
 
-    size_t HammingDistance(const Sequence& s1, const Sequence& s2) const {
+    size_t HammingDistance(const SequenceView& s1, const SequenceView& s2) const {
         VERIFY(s1.size() == s2.size());
         size_t dist = 0;
         for (size_t i = 0; i < s1.size(); ++i) {
@@ -493,7 +498,7 @@ class HammingGapAnalyzer: public GapAnalyzer {
         return dist;
     }
 
-    double ScoreGap(const Sequence& s1, const Sequence& s2) const {
+    double ScoreGap(const SequenceView& s1, const SequenceView& s2) const {
         VERIFY(s1.size() == s2.size());
         return 1.0 - (double) HammingDistance(s1, s2) / (double) s1.size();
     }
@@ -541,8 +546,8 @@ public:
             //TRACE("Sink: " << g_.EdgeNucls(sink).Subseq(g_.length(sink) + g_.k() - l).str());
             //TRACE("Source: " << g_.EdgeNucls(source).Subseq(0, l));
             double score = 0;
-            score = ScoreGap(g_.EdgeNucls(gap.left()).Subseq(g_.length(gap.left()) + g_.k() - l),
-                                    g_.EdgeNucls(gap.right()).Subseq(0, l));
+            score = ScoreGap(g_.EdgeNuclsView(gap.left()).Subseq(g_.length(gap.left()) + g_.k() - l),
+                                    g_.EdgeNuclsView(gap.right()).Subseq(0, l));
             if (math::gr(score, best_score)) {
                 TRACE("Curr overlap " << l);
                 TRACE("Score: " << score);
@@ -847,23 +852,35 @@ protected:
 
 class CompositeExtender {
 public:
-
+    typedef std::vector<std::shared_ptr<PathExtender>> ExtendersT;
+    //Creates a fresh set of extenders bound to given coverage map and used edge storage.
+    //In parallel mode every thread gets its own set, so extenders of different sets must not share
+    //mutable state: everything else they refer to (graph, paired indices, unique edge storages,
+    //long reads coverage maps) is only read during the growth.
+    typedef std::function<ExtendersT(const GraphCoverageMap&, UsedUniqueStorage&)> ExtendersFactory;
+
+    //If extenders factory is provided, seeds from independent graph components are grown in parallel
     CompositeExtender(const Graph &g, GraphCoverageMap& cov_map,
                       UsedUniqueStorage &unique,
-                      const std::vector<std::shared_ptr<PathExtender>> &pes)
+                      const ExtendersT &pes,
+                      const ExtendersFactory &extenders_factory = nullptr)
             : g_(g),
               cover_map_(cov_map),
               used_storage_(unique),
-              extenders_(pes) {}
+              extenders_(pes),
+              extenders_factory_(extenders_factory) {}
 
     void GrowAll(PathContainer& paths, PathContainer& result) {
         result.clear();
-        GrowAllPaths(paths, result);
+        if (extenders_factory_ && omp_get_max_threads() > 1 && cover_map_.size() == 0)
+            GrowAllPathsParallel(paths, result);
+        else
+            GrowAllPaths(paths, result);
         result.FilterEmptyPaths();
     }
 
     void GrowPath(BidirectionalPath& path, PathContainer* paths_storage) {
-        while (MakeGrowStep(path, paths_storage)) { }
+        GrowPath(path, paths_storage, extenders_);
     }
 
 
@@ -871,67 +888,252 @@ private:
     const Graph &g_;
     GraphCoverageMap &cover_map_;
     UsedUniqueStorage &used_storage_;
-    std::vector<std::shared_ptr<PathExtender>> extenders_;
+    ExtendersT extenders_;
+    ExtendersFactory extenders_factory_;
+
+    //Private state of a thread in parallel mode
+    struct GrowthContext {
+        GraphCoverageMap cover_map;
+        UsedUniqueStorage used_storage;
+        ExtendersT extenders;
+
+        GrowthContext(const Graph &g, const ScaffoldingUniqueEdgeStorage &unique)
+                : cover_map(g), used_storage(unique, g) {}
+    };
 
-    bool MakeGrowStep(BidirectionalPath& path, PathContainer* paths_storage) {
+    //Seeds lying in the same set of connected components, grown together in the serial order
+    struct SeedGroup {
+        size_t root;
+        size_t component_cnt;
+        std::vector<size_t> seeds;
+        //i-th seed produced paths [ends[i - 1], ends[i])
+        std::vector<size_t> ends;
+        PathContainer paths;
+        //paths which should be subscribed to the coverage map
+        std::vector<BidirectionalPath*> covering;
+        UsedUniqueStorage used_storage;
+        //components visited by the paths, but not belonging to the group
+        std::set<size_t> foreign_components;
+
+        SeedGroup(size_t root_, size_t component_cnt_,
+                  const Graph &g, const ScaffoldingUniqueEdgeStorage &unique)
+                : root(root_), component_cnt(component_cnt_), used_storage(unique, g) {}
+    };
+
+    static bool MakeGrowStep(BidirectionalPath& path, PathContainer* paths_storage, const ExtendersT &extenders) {
         DEBUG("make grow step composite extender");
 
         size_t current = 0;
-        while (current < extenders_.size()) {
-            DEBUG("step " << current << " of total " << extenders_.size());
-            if (extenders_[current]->MakeGrowStep(path, paths_storage)) {
+        while (current < extenders.size()) {
+            DEBUG("step " << current << " of total " << extenders.size());
+            if (extenders[current]->MakeGrowStep(path, paths_storage)) {
                 return true;
             }
            ++current;
         }
         return false;
     }
-    
+
+    static void GrowPath(BidirectionalPath& path, PathContainer* paths_storage, const ExtendersT &extenders) {
+        while (MakeGrowStep(path, paths_storage, extenders)) { }
+    }
+
+    void GrowSeed(const BidirectionalPath &seed, const BidirectionalPath &conj_seed,
+                  GraphCoverageMap &cover_map, UsedUniqueStorage &used_storage,
+                  const ExtendersT &extenders, PathContainer& result) const {
+        //In 2015 modes do not use a seed already used in paths.
+        //FIXME what is the logic here?
+        if (used_storage.UniqueCheckEnabled()) {
+            bool was_used = false;
+            for (size_t ind =0; ind < seed.Size(); ind++) {
+                EdgeId eid = seed.At(ind);
+                if (used_storage.IsUsedAndUnique(eid)) {
+                    DEBUG("Used edge " << g_.int_id(eid));
+                    was_used = true;
+                    break;
+                } else {
+                    used_storage.insert(eid);
+                }
+            }
+            if (was_used) {
+                DEBUG("skipping already used seed");
+                return;
+            }
+        }
+
+        if (!cover_map.IsCovered(seed)) {
+            AddPath(result, seed, cover_map);
+            BidirectionalPath * path = new BidirectionalPath(seed);
+            BidirectionalPath * conjugatePath = new BidirectionalPath(conj_seed);
+            SubscribeCoverageMap(path, cover_map);
+            SubscribeCoverageMap(conjugatePath, cover_map);
+            result.AddPair(path, conjugatePath);
+            size_t count_trying = 0;
+            size_t current_path_len = 0;
+            do {
+                current_path_len = path->Length();
+                count_trying++;
+                GrowPath(*path, &result, extenders);
+                GrowPath(*conjugatePath, &result, extenders);
+            } while (count_trying < 10 && (path->Length() != current_path_len));
+            DEBUG("result path " << path->GetId());
+            path->PrintDEBUG();
+        }
+    }
+
     void GrowAllPaths(PathContainer& paths, PathContainer& result) {
         for (size_t i = 0; i < paths.size(); ++i) {
             VERBOSE_POWER_T2(i, 100, "Processed " << i << " paths from " << paths.size() << " (" << i * 100 / paths.size() << "%)");
             if (paths.size() > 10 && i % (paths.size() / 10 + 1) == 0) {
                 INFO("Processed " << i << " paths from " << paths.size() << " (" << i * 100 / paths.size() << "%)");
             }
-            //In 2015 modes do not use a seed already used in paths.
-            //FIXME what is the logic here?
-            if (used_storage_.UniqueCheckEnabled()) {
-                bool was_used = false;
-                for (size_t ind =0; ind < paths.Get(i)->Size(); ind++) {
-                    EdgeId eid = paths.Get(i)->At(ind);
-                    if (used_storage_.IsUsedAndUnique(eid)) {
-                        DEBUG("Used edge " << g_.int_id(eid));
-                        was_used = true;
-                        break;
-                    } else {
-                        used_storage_.insert(eid);
-                    }
+            GrowSeed(*paths.Get(i), *paths.GetConjugate(i), cover_map_, used_storage_, extenders_, result);
+        }
+    }
+
+    //Grows the seeds of the group with thread-private coverage map and used storage,
+    //then detaches produced paths from them
+    void GrowGroup(const PathContainer& paths, const debruijn_graph::ConnectedComponentCounter &components,
+                   const dsu::ConcurrentDSU &groups, GrowthContext &context, SeedGroup &group) const {
+        for (size_t i : group.seeds) {
+            GrowSeed(*paths.Get(i), *paths.GetConjugate(i), context.cover_map, context.used_storage,
+                     context.extenders, group.paths);
+            group.ends.push_back(group.paths.size());
+        }
+
+        for (auto iter = group.paths.begin(); iter != group.paths.end(); ++iter) {
+            for (BidirectionalPath *path : {iter.get(), iter.getConjugate()}) {
+                for (EdgeId e : *path) {
+                    size_t component = components.GetComponent(e);
+                    if (groups.find_set(component) != group.root)
+                        group.foreign_components.insert(component);
                 }
-                if (was_used) {
-                    DEBUG("skipping already used seed");
+                if (context.cover_map.Unsubscribe(path))
+                    group.covering.push_back(path);
+            }
+        }
+        group.used_storage.insert_all(context.used_storage);
+        context.used_storage.clear();
+    }
+
+    //Paths grown from seeds in different connected components do not interact unless some extender
+    //jumps between components. Seeds are grouped by components and groups are grown speculatively
+    //in parallel; groups whose paths leave their components are merged with the visited ones and regrown.
+    //Every group is grown by a single thread in the seed order, so within a group paths are created
+    //in the same order as in serial mode. Resulting paths are collected in the seed order and renumbered,
+    //so the order of their ids (used by coverage maps and path sets) is the serial one as well.
+    void GrowAllPathsParallel(PathContainer& paths, PathContainer& result) {
+        const size_t NO_COMPONENT = std::numeric_limits<size_t>::max();
+        size_t nthreads = omp_get_max_threads();
+        INFO("Growing " << paths.size() << " seeds using " << nthreads << " threads");
+
+        debruijn_graph::ConnectedComponentCounter components(g_);
+        components.CalculateComponents();
+        dsu::ConcurrentDSU groups(components.component_total_len_.size());
+
+        std::vector<size_t> seed_components(paths.size(), NO_COMPONENT);
+        for (size_t i = 0; i < paths.size(); ++i) {
+            const BidirectionalPath &seed = *paths.Get(i);
+            if (seed.Empty())
+                continue;
+            seed_components[i] = components.GetComponent(seed.Front());
+            for (EdgeId e : seed)
+                groups.unite(seed_components[i], components.GetComponent(e));
+        }
+
+        std::vector<std::unique_ptr<GrowthContext>> contexts;
+        for (size_t i = 0; i < nthreads; ++i) {
+            contexts.emplace_back(new GrowthContext(g_, used_storage_.unique_edge_storage()));
+            contexts.back()->extenders = extenders_factory_(contexts.back()->cover_map,
+                                                            contexts.back()->used_storage);
+        }
+
+        std::unordered_map<size_t, std::unique_ptr<SeedGroup>> grown;
+        size_t round = 0;
+        while (true) {
+            std::unordered_map<size_t, size_t> pending_ids;
+            std::vector<std::unique_ptr<SeedGroup>> pending;
+            for (size_t i = 0; i < paths.size(); ++i) {
+                if (seed_components[i] == NO_COMPONENT)
+                    continue;
+                size_t root = groups.find_set(seed_components[i]);
+                if (grown.count(root))
                     continue;
+                auto it = pending_ids.find(root);
+                if (it == pending_ids.end()) {
+                    it = pending_ids.insert(std::make_pair(root, pending.size())).first;
+                    pending.emplace_back(new SeedGroup(root, groups.set_size(root),
+                                                       g_, used_storage_.unique_edge_storage()));
                 }
+                pending[it->second]->seeds.push_back(i);
             }
+            if (pending.empty())
+                break;
 
-            if (!cover_map_.IsCovered(*paths.Get(i))) {
-                AddPath(result, *paths.Get(i), cover_map_);
-                BidirectionalPath * path = new BidirectionalPath(*paths.Get(i));
-                BidirectionalPath * conjugatePath = new BidirectionalPath(*paths.GetConjugate(i));
-                SubscribeCoverageMap(path, cover_map_);
-                SubscribeCoverageMap(conjugatePath, cover_map_);
-                result.AddPair(path, conjugatePath);
-                size_t count_trying = 0;
-                size_t current_path_len = 0;
-                do {
-                    current_path_len = path->Length();
-                    count_trying++;
-                    GrowPath(*path, &result);
-                    GrowPath(*conjugatePath, &result);
-                } while (count_trying < 10 && (path->Length() != current_path_len));
-                DEBUG("result path " << path->GetId());
-                path->PrintDEBUG();
+            INFO("Round " << ++round << ": growing " << pending.size() << " independent seed groups");
+            //larger groups go first for better load balancing
+            std::stable_sort(pending.begin(), pending.end(),
+                             [](const std::unique_ptr<SeedGroup> &a, const std::unique_ptr<SeedGroup> &b) {
+                                 return a->seeds.size() > b->seeds.size();
+                             });
+
+            #pragma omp parallel for schedule(dynamic)
+            for (size_t i = 0; i < pending.size(); ++i) {
+                GrowGroup(paths, components, groups, *contexts[omp_get_thread_num()], *pending[i]);
+            }
+
+            size_t conflicts = 0;
+            for (auto &group : pending) {
+                if (group->foreign_components.empty())
+                    continue;
+                ++conflicts;
+                for (size_t component : group->foreign_components)
+                    groups.unite(group->root, component);
+                group.reset();
+            }
+            for (auto &group : pending) {
+                if (group)
+                    grown[group->root] = std::move(group);
+            }
+            //drop the results of groups that were merged with conflicting ones
+            for (auto it = grown.begin(); it != grown.end(); ) {
+                if (!groups.is_root(it->first) || groups.set_size(it->first) != it->second->component_cnt)
+                    it = grown.erase(it);
+                else
+                    ++it;
             }
+            DEBUG(conflicts << " groups left their components and will be regrown");
+        }
+
+        std::unordered_map<size_t, size_t> processed_cnt;
+        for (size_t i = 0; i < paths.size(); ++i) {
+            if (seed_components[i] == NO_COMPONENT)
+                continue;
+            SeedGroup &group = *grown.at(groups.find_set(seed_components[i]));
+            size_t &cnt = processed_cnt[group.root];
+            size_t begin = cnt == 0 ? 0 : group.ends[cnt - 1];
+            size_t end = group.ends[cnt];
+            ++cnt;
+            for (size_t j = begin; j < end; ++j)
+                result.AddLinkedPair(group.paths.Get(j), group.paths.GetConjugate(j));
+        }
+
+        //ids were taken in the thread completion order
+        uint64_t id = BidirectionalPath::ReserveIds(2 * result.size());
+        for (auto iter = result.begin(); iter != result.end(); ++iter) {
+            iter.get()->SetId(id++);
+            iter.getConjugate()->SetId(id++);
+        }
+
+        for (auto &entry : grown) {
+            SeedGroup &group = *entry.second;
+            for (BidirectionalPath *path : group.covering)
+                SubscribeCoverageMap(path, cover_map_);
+            used_storage_.insert_all(group.used_storage);
+            //paths are owned by result now
+            group.paths.clear();
         }
+        INFO("Seeds grown in " << round << " rounds");
     }
 
 };
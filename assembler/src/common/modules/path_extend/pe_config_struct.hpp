@@ -68,6 +68,7 @@ struct pe_config {
         size_t split_edge_length;
 
         bool multi_path_extend;
+        bool parallel_extension;
 
         struct OverlapRemovalOptionsT {
             bool enabled;
@@ -16,6 +16,11 @@
 #define PE_UTILS_HPP_
 
 #include "assembly_graph/paths/bidirectional_path.hpp"
+#include "assembly_graph/paths/bidirectional_path_container.hpp"
+#include "adt/small_pod_vector.hpp"
+
+#include <algorithm>
+#include <vector>
 
 namespace path_extend {
 
@@ -40,33 +45,72 @@ inline bool InTwoEdgeCycle(EdgeId e, const Graph &g) {
 
 // Handles all paths in PathContainer.
 // For each edge output all paths  that _traverse_ this path. If path contains multiple instances - count them. Position of the edge is not reported.
+//Paths covering a single edge, kept sorted by path id (same order as BidirectionalPathMultiset).
+//Stored inline in a pointer-sized vector, so that empty and small lists cost no extra allocation.
+class EdgePathList {
+    typedef adt::SmallPODVector<BidirectionalPath*> StorageT;
+    StorageT paths_;
+
+public:
+    typedef StorageT::const_iterator const_iterator;
+
+    void insert(BidirectionalPath *path) {
+        paths_.insert(std::upper_bound(paths_.begin(), paths_.end(), path, PathComparator()), path);
+    }
+
+    //Removes single instance of the path, returns false if there were none
+    bool erase(BidirectionalPath *path) {
+        auto range = std::equal_range(paths_.begin(), paths_.end(), path, PathComparator());
+        if (range.first == range.second)
+            return false;
+        paths_.erase(range.first);
+        return true;
+    }
+
+    size_t count(const BidirectionalPath *path) const {
+        auto range = std::equal_range(paths_.begin(), paths_.end(), path, PathComparator());
+        return size_t(range.second - range.first);
+    }
+
+    size_t size() const { return paths_.size(); }
+    bool empty() const { return paths_.empty(); }
+
+    const_iterator begin() const { return paths_.begin(); }
+    const_iterator end() const { return paths_.end(); }
+};
+
+//Edge-id-indexed coverage of graph edges by paths.
+//Concurrent reads are safe as long as no path subscribed to the map is modified.
 class GraphCoverageMap: public PathListener {
 public:
-    typedef BidirectionalPathMultiset MapDataT;
+    typedef EdgePathList MapDataT;
 
 private:
     const Graph& g_;
 
-    std::unordered_map<EdgeId, MapDataT * > edge_coverage_;
+    std::vector<MapDataT> edge_coverage_;
     const MapDataT empty_;
+    size_t covered_edges_;
 
     void EdgeAdded(EdgeId e, BidirectionalPath * path) {
-        auto iter = edge_coverage_.find(e);
-        if (iter == edge_coverage_.end()) {
-            edge_coverage_.insert(std::make_pair(e, new MapDataT()));
-        }
-        edge_coverage_[e]->insert(path);
+        size_t id = e.int_id();
+        if (id >= edge_coverage_.size())
+            edge_coverage_.resize(std::max(id + 1, g_.ereserved()));
+        MapDataT &paths = edge_coverage_[id];
+        if (paths.empty())
+            ++covered_edges_;
+        paths.insert(path);
     }
 
     void EdgeRemoved(EdgeId e, BidirectionalPath * path) {
-        auto iter = edge_coverage_.find(e);
-        if (iter != edge_coverage_.end()) {
-            if (iter->second->count(path) == 0) {
-                DEBUG("Error erasing path from coverage map");
-            } else {
-                auto entry = iter->second->find(path);
-                iter->second->erase(entry);
-            }
+        size_t id = e.int_id();
+        if (id >= edge_coverage_.size())
+            return;
+        MapDataT &paths = edge_coverage_[id];
+        if (!paths.erase(path)) {
+            DEBUG("Error erasing path from coverage map");
+        } else if (paths.empty()) {
+            --covered_edges_;
         }
     }
 
@@ -78,23 +122,14 @@ private:
         }
     }
 
-    size_t EdgeCount() const {
-        size_t result = 0;
-        for (auto e = g_.ConstEdgeBegin(); !e.IsEnd(); ++e) {
-            ++result;
-        }
-        return result;
-    }
-
 public:
     GraphCoverageMap(const GraphCoverageMap&) = delete;
     GraphCoverageMap& operator=(const GraphCoverageMap&) = delete;
 
     GraphCoverageMap(GraphCoverageMap&&) = default;
 
-    explicit GraphCoverageMap(const Graph& g) : g_(g) {
-        //FIXME heavy constructor
-        edge_coverage_.reserve(EdgeCount());
+    explicit GraphCoverageMap(const Graph& g)
+            : g_(g), edge_coverage_(g.ereserved()), covered_edges_(0) {
     }
 
     GraphCoverageMap(const Graph& g, const PathContainer& paths, bool subscribe = false) :
@@ -102,12 +137,6 @@ public:
         AddPaths(paths, subscribe);
     }
 
-    ~GraphCoverageMap() {
-        for (auto iter = edge_coverage_.begin(); iter != edge_coverage_.end(); ++iter) {
-            delete iter->second;
-        }
-    }
-
     void AddPaths(const PathContainer& paths, bool subscribe = false) {
         for (auto path_pair : paths) {
             ProcessPath(path_pair.first, subscribe);
@@ -119,6 +148,16 @@ public:
         ProcessPath(path, true);
     }
 
+    //Returns false if path was not subscribed to this map
+    bool Unsubscribe(BidirectionalPath * path) {
+        if (!path->Unsubscribe(this))
+            return false;
+        for (size_t i = 0; i < path->Size(); ++i) {
+            EdgeRemoved(path->At(i), path);
+        }
+        return true;
+    }
+
     //Inherited from PathListener
     void FrontEdgeAdded(EdgeId e, BidirectionalPath * path, const Gap&) override {
         EdgeAdded(e, path);
@@ -140,11 +179,8 @@ public:
     }
 
     const MapDataT *  GetEdgePaths(EdgeId e) const {
-        auto iter = edge_coverage_.find(e);
-        if (iter != edge_coverage_.end()) {
-            return iter->second;
-        }
-        return &empty_;
+        size_t id = e.int_id();
+        return id < edge_coverage_.size() ? &edge_coverage_[id] : &empty_;
     }
 
     int GetCoverage(EdgeId e) const {
@@ -169,16 +205,9 @@ public:
         return BidirectionalPathSet(mapData->begin(), mapData->end());
     }
 
-    std::unordered_map <EdgeId, MapDataT * >::const_iterator begin() const {
-        return edge_coverage_.begin();
-    }
-
-    std::unordered_map <EdgeId, MapDataT * >::const_iterator end() const {
-        return edge_coverage_.end();
-    }
-
+    //Number of edges covered by at least one path
     size_t size() const {
-        return edge_coverage_.size();
+        return covered_edges_;
     }
 
     const Graph& graph() const {
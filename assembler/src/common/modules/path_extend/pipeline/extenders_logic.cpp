@@ -47,7 +47,7 @@ shared_ptr<SimpleExtender> ExtendersGenerator::MakeLongReadsExtender(size_t lib_
 shared_ptr<SimpleExtender> ExtendersGenerator::MakeLongEdgePEExtender(size_t lib_index,
                                                                       bool investigate_loops) const {
     const auto &lib = dataset_info_.reads[lib_index];
-    shared_ptr<PairedInfoLibrary> paired_lib = MakeNewLib(gp_.g, lib, gp_.clustered_indices[lib_index]);
+    shared_ptr<PairedInfoLibrary> paired_lib = MakeNewLib(gp_.g, lib, frozen_indices_.clustered[lib_index]);
     //INFO("Threshold for lib #" << lib_index << ": " << paired_lib->GetSingleThreshold());
 
     shared_ptr<WeightCounter> wc =
@@ -99,7 +99,7 @@ shared_ptr<PathExtender> ExtendersGenerator::MakeScaffoldingExtender(size_t lib_
 
     const auto &lib = dataset_info_.reads[lib_index];
     const auto &pset = params_.pset;
-    shared_ptr<PairedInfoLibrary> paired_lib = MakeNewLib(gp_.g, lib, gp_.scaffolding_indices[lib_index]);
+    shared_ptr<PairedInfoLibrary> paired_lib = MakeNewLib(gp_.g, lib, frozen_indices_.scaffolding[lib_index]);
 
     shared_ptr<WeightCounter> counter = make_shared<ReadCountWeightCounter>(gp_.g, paired_lib);
 
@@ -187,12 +187,12 @@ shared_ptr<PathExtender> ExtendersGenerator::MakeMatePairScaffoldingExtender(siz
     INFO("Creating Scaffolding 2015 extender for lib #" << lib_index);
 
     //FIXME: DimaA
-    if (gp_.paired_indices[lib_index].size() > gp_.clustered_indices[lib_index].size()) {
+    if (gp_.paired_indices[lib_index].size() > frozen_indices_.clustered[lib_index].size()) {
         INFO("Paired unclustered indices not empty, using them");
         paired_lib = MakeNewLib(gp_.g, lib, gp_.paired_indices[lib_index]);
-    } else if (gp_.clustered_indices[lib_index].size() != 0) {
+    } else if (frozen_indices_.clustered[lib_index].size() != 0) {
         INFO("clustered indices not empty, using them");
-        paired_lib = MakeNewLib(gp_.g, lib, gp_.clustered_indices[lib_index]);
+        paired_lib = MakeNewLib(gp_.g, lib, frozen_indices_.clustered[lib_index]);
     } else {
         ERROR("All paired indices are empty!");
     }
@@ -223,7 +223,7 @@ shared_ptr<PathExtender> ExtendersGenerator::MakeMatePairScaffoldingExtender(siz
 
 shared_ptr<SimpleExtender> ExtendersGenerator::MakeCoordCoverageExtender(size_t lib_index) const {
     const auto& lib = dataset_info_.reads[lib_index];
-    shared_ptr<PairedInfoLibrary> paired_lib = MakeNewLib(gp_.g, lib, gp_.clustered_indices[lib_index]);
+    shared_ptr<PairedInfoLibrary> paired_lib = MakeNewLib(gp_.g, lib, frozen_indices_.clustered[lib_index]);
 
     auto provider = make_shared<CoverageAwareIdealInfoProvider>(gp_.g, paired_lib, lib.data().unmerged_read_length);
 
@@ -254,7 +254,7 @@ shared_ptr<SimpleExtender> ExtendersGenerator::MakeCoordCoverageExtender(size_t
 shared_ptr<SimpleExtender> ExtendersGenerator::MakeRNAExtender(size_t lib_index, bool investigate_loops) const {
 
     const auto &lib = dataset_info_.reads[lib_index];
-    shared_ptr<PairedInfoLibrary> paired_lib = MakeNewLib(gp_.g, lib, gp_.clustered_indices[lib_index]);
+    shared_ptr<PairedInfoLibrary> paired_lib = MakeNewLib(gp_.g, lib, frozen_indices_.clustered[lib_index]);
 //    INFO("Threshold for lib #" << lib_index << ": " << paired_lib->GetSingleThreshold());
 
     auto cip = make_shared<CoverageAwareIdealInfoProvider>(gp_.g, paired_lib, lib.data().unmerged_read_length);
@@ -298,7 +298,7 @@ shared_ptr<SimpleExtender> ExtendersGenerator::MakeSimpleCoverageExtender(size_t
 
 shared_ptr<SimpleExtender> ExtendersGenerator::MakePEExtender(size_t lib_index, bool investigate_loops) const {
     const auto &lib = dataset_info_.reads[lib_index];
-    shared_ptr<PairedInfoLibrary> paired_lib = MakeNewLib(gp_.g, lib, gp_.clustered_indices[lib_index]);
+    shared_ptr<PairedInfoLibrary> paired_lib = MakeNewLib(gp_.g, lib, frozen_indices_.clustered[lib_index]);
     VERIFY_MSG(!paired_lib->IsMp(), "Tried to create PE extender for MP library");
     auto opts = params_.pset.extension_options;
 //    INFO("Threshold for lib #" << lib_index << ": " << paired_lib->GetSingleThreshold());
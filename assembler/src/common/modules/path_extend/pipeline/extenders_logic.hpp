@@ -44,6 +44,7 @@ class ExtendersGenerator {
     const config::dataset &dataset_info_;
     const PathExtendParamsContainer &params_;
     const conj_graph_pack &gp_;
+    const FrozenPairedIndices &frozen_indices_;
 
     const GraphCoverageMap &cover_map_;
     const UniqueData &unique_data_;
@@ -55,6 +56,7 @@ public:
     ExtendersGenerator(const config::dataset &dataset_info,
                        const PathExtendParamsContainer &params,
                        const conj_graph_pack &gp,
+                       const FrozenPairedIndices &frozen_indices,
                        const GraphCoverageMap &cover_map,
                        const UniqueData &unique_data,
                        UsedUniqueStorage &used_unique_storage,
@@ -62,6 +64,7 @@ public:
         dataset_info_(dataset_info),
         params_(params),
         gp_(gp),
+        frozen_indices_(frozen_indices),
         cover_map_(cover_map),
         unique_data_(unique_data),
         used_unique_storage_(used_unique_storage),
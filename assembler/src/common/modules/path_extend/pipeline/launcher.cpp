@@ -34,7 +34,7 @@ vector<shared_ptr<ConnectionCondition>>
             if (lib.is_mate_pair())
                 paired_lib = MakeNewLib(gp_.g, lib, gp_.paired_indices[lib_index]);
             else if (lib.type() == io::LibraryType::PairedEnd)
-                paired_lib = MakeNewLib(gp_.g, lib, gp_.clustered_indices[lib_index]);
+                paired_lib = MakeNewLib(gp_.g, lib, frozen_indices_.clustered[lib_index]);
             else {
                 INFO("Unusable for scaffold graph paired lib #" << lib_index);
                 continue;
@@ -61,7 +61,8 @@ shared_ptr<scaffold_graph::ScaffoldGraph> PathExtendLauncher::ConstructScaffoldG
         ConstructPairedConnectionConditions(edge_storage);
 
     if (params.use_graph_connectivity) {
-        auto as_con = make_shared<AssemblyGraphConnectionCondition>(gp_.g, params.max_path_length, edge_storage);
+        auto as_con = make_shared<AssemblyGraphConnectionCondition>(gp_.g, params.max_path_length, edge_storage,
+                                                                  &gp_.compact_layout);
         as_con->AddInterestingEdges(edge_condition);
         conditions.push_back(as_con);
     }
@@ -112,6 +113,7 @@ void PathExtendLauncher::MakeAndOutputScaffoldGraph() const {
                                                                 params_.pset.genome_consistency_checker.relative_max_gap,
                                                                 unique_data_.main_unique_storage_.min_length(),
                                                                 unique_data_.main_unique_storage_,
+                                                                frozen_indices_.clustered,
                                                                 unique_data_.long_reads_cov_map_,
                                                                 dataset_info_.reads);
         scaffold_graph = ConstructScaffoldGraph(unique_data_.main_unique_storage_);
@@ -140,6 +142,7 @@ void PathExtendLauncher::CountMisassembliesWithReference(const PathContainer &pa
                                                             params_.pset.genome_consistency_checker.relative_max_gap,
                                                             unresolvable_gap,
                                                             use_main_storage ? unique_data_.main_unique_storage_ : tmp_storage,
+                                                            frozen_indices_.clustered,
                                                             unique_data_.long_reads_cov_map_,
                                                             dataset_info_.reads);
 
@@ -299,7 +302,8 @@ void PathExtendLauncher::TraverseLoops(PathContainer &paths, GraphCoverageMap &c
         loopTraverser(cover_map.graph(), cover_map,
                       params_.pset.loop_traversal.min_edge_length,
                       params_.pset.loop_traversal.max_component_size,
-                      params_.pset.loop_traversal.max_path_length);
+                      params_.pset.loop_traversal.max_path_length,
+                      &gp_.compact_layout);
     size_t res = loopTraverser.TraverseAllLoops();
     paths.SortByLength();
 
@@ -313,7 +317,7 @@ void PathExtendLauncher::AddScaffUniqueStorage(size_t uniqe_edge_len) {
     additional_edge_analyzer.FillUniqueEdgeStorage(unique_data_.unique_storages_.back());
 }
 
-Extenders PathExtendLauncher::ConstructMPExtenders(const ExtendersGenerator &generator) {
+void PathExtendLauncher::FillMPUniqueEdgeStorages() {
     const pe_config::ParamSetT &pset = params_.pset;
 
     size_t cur_length = unique_data_.min_unique_length_ - pset.scaffolding2015.unique_length_step;
@@ -328,8 +332,6 @@ Extenders PathExtendLauncher::ConstructMPExtenders(const ExtendersGenerator &gen
         INFO("Will add final extenders for length " << lower_bound);
         AddScaffUniqueStorage(lower_bound);
     }
-
-    return generator.MakeMPExtenders();
 }
 
 void PathExtendLauncher::FillPathContainer(size_t lib_index, size_t size_threshold) {
@@ -382,7 +384,8 @@ void  PathExtendLauncher::FillPBUniqueEdgeStorages() {
         INFO("Removing fake unique with paired-end libs");
         for (size_t lib_index = 0; lib_index < dataset_info_.reads.lib_count(); lib_index++) {
             if (dataset_info_.reads[lib_index].type() == io::LibraryType::PairedEnd) {
-                unique_edge_analyzer_pb.ClearLongEdgesWithPairedLib(lib_index, unique_data_.unique_pb_storage_);
+                unique_edge_analyzer_pb.ClearLongEdgesWithPairedLib(frozen_indices_.clustered[lib_index],
+                                                                    unique_data_.unique_pb_storage_);
             }
         }
 
@@ -393,28 +396,18 @@ void  PathExtendLauncher::FillPBUniqueEdgeStorages() {
     INFO(unique_data_.unique_pb_storage_.size() << " unique edges");
 }
 
-Extenders PathExtendLauncher::ConstructPBExtenders(const ExtendersGenerator &generator) {
-    FillPBUniqueEdgeStorages();
-    return generator.MakePBScaffoldingExtenders();
-}
-
-
 Extenders PathExtendLauncher::ConstructExtenders(const GraphCoverageMap &cover_map,
                                                  UsedUniqueStorage &used_unique_storage) {
     INFO("Creating main extenders, unique edge length = " << unique_data_.min_unique_length_);
     if (!config::PipelineHelper::IsPlasmidPipeline(params_.mode) &&  (support_.SingleReadsMapped() || support_.HasLongReads()))
         FillLongReadsCoverageMaps();
-    ExtendersGenerator generator(dataset_info_, params_, gp_, cover_map,
-                                 unique_data_, used_unique_storage, support_);
-    Extenders extenders = generator.MakeBasicExtenders();
 
     //long reads scaffolding extenders.
-
     if (!config::PipelineHelper::IsPlasmidPipeline(params_.mode) && support_.HasLongReads()) {
         if (params_.pset.sm == scaffolding_mode::sm_old) {
             INFO("Will not use new long read scaffolding algorithm in this mode");
         } else {
-            utils::push_back_all(extenders, ConstructPBExtenders(generator));
+            FillPBUniqueEdgeStorages();
         }
     }
 
@@ -422,14 +415,33 @@ Extenders PathExtendLauncher::ConstructExtenders(const GraphCoverageMap &cover_m
         if (params_.pset.sm == scaffolding_mode::sm_old) {
             INFO("Will not use mate-pairs is this mode");
         } else {
-            utils::push_back_all(extenders, ConstructMPExtenders(generator));
+            FillMPUniqueEdgeStorages();
         }
     }
 
+    Extenders extenders = MakeExtenders(cover_map, used_unique_storage);
+    INFO("Total number of extenders is " << extenders.size());
+    return extenders;
+}
+
+Extenders PathExtendLauncher::MakeExtenders(const GraphCoverageMap &cover_map,
+                                            UsedUniqueStorage &used_unique_storage) const {
+    ExtendersGenerator generator(dataset_info_, params_, gp_, frozen_indices_, cover_map,
+                                 unique_data_, used_unique_storage, support_);
+    Extenders extenders = generator.MakeBasicExtenders();
+
+    if (!config::PipelineHelper::IsPlasmidPipeline(params_.mode) && support_.HasLongReads() &&
+        params_.pset.sm != scaffolding_mode::sm_old) {
+        utils::push_back_all(extenders, generator.MakePBScaffoldingExtenders());
+    }
+
+    if (support_.HasMPReads() && params_.pset.sm != scaffolding_mode::sm_old) {
+        utils::push_back_all(extenders, generator.MakeMPExtenders());
+    }
+
     if (params_.pset.use_coordinated_coverage)
         utils::push_back_all(extenders, generator.MakeCoverageExtenders());
 
-    INFO("Total number of extenders is " << extenders.size());
     return extenders;
 }
 
@@ -440,13 +452,14 @@ void PathExtendLauncher::PolishPaths(const PathContainer &paths, PathContainer &
 
     vector<shared_ptr<PathGapCloser>> gap_closers;
 
-    gap_closers.push_back(make_shared<DijkstraGapCloser>(gp_.g, params_.max_polisher_gap));
+    gap_closers.push_back(make_shared<DijkstraGapCloser>(gp_.g, params_.max_polisher_gap, &gp_.compact_layout));
     for (size_t i = 0; i < dataset_info_.reads.lib_count(); i++) {
         auto lib = dataset_info_.reads[i];
         if (lib.type() == io::LibraryType::HQMatePairs || lib.type() == io::LibraryType::MatePairs) {
             shared_ptr<PairedInfoLibrary> paired_lib = MakeNewLib(gp_.g, lib, gp_.paired_indices[i]);
             gap_closers.push_back(make_shared<MatePairGapCloser> (gp_.g, params_.max_polisher_gap, paired_lib,
-                                                                   unique_data_.main_unique_storage_));
+                                                                   unique_data_.main_unique_storage_,
+                                                                   &gp_.compact_layout));
         }
     }
 
@@ -563,9 +576,16 @@ void PathExtendLauncher::Launch() {
     GraphCoverageMap cover_map(gp_.g);
     UsedUniqueStorage used_unique_storage(unique_data_.main_unique_storage_, gp_.g);
     Extenders extenders = ConstructExtenders(cover_map, used_unique_storage);
+    CompositeExtender::ExtendersFactory extenders_factory;
+    if (params_.pset.parallel_extension) {
+        extenders_factory = [this](const GraphCoverageMap &thread_cover_map, UsedUniqueStorage &thread_used_storage) {
+            return MakeExtenders(thread_cover_map, thread_used_storage);
+        };
+    }
     CompositeExtender composite_extender(gp_.g, cover_map,
                                          used_unique_storage,
-                                         extenders);
+                                         extenders,
+                                         extenders_factory);
 
     auto paths = resolver.ExtendSeeds(seeds, composite_extender);
     DebugOutputPaths(paths, "raw_paths");
@@ -23,6 +23,7 @@ class PathExtendLauncher {
     const config::dataset& dataset_info_;
     const PathExtendParamsContainer& params_;
     conj_graph_pack& gp_;
+    FrozenPairedIndices frozen_indices_;
     PELaunchSupport support_;
 
     std::shared_ptr<ContigNameGenerator> contig_name_generator_;
@@ -71,11 +72,12 @@ class PathExtendLauncher {
 
     Extenders ConstructExtenders(const GraphCoverageMap &cover_map, UsedUniqueStorage &used_unique_storage);
 
-    Extenders ConstructMPExtenders(const ExtendersGenerator &generator);
+    //Only creates extenders, all the necessary storages are filled by ConstructExtenders
+    Extenders MakeExtenders(const GraphCoverageMap &cover_map, UsedUniqueStorage &used_unique_storage) const;
 
-    void AddScaffUniqueStorage(size_t uniqe_edge_len);
+    void FillMPUniqueEdgeStorages();
 
-    Extenders ConstructPBExtenders(const ExtendersGenerator &generator);
+    void AddScaffUniqueStorage(size_t uniqe_edge_len);
 
     void FilterPaths();
 
@@ -91,6 +93,7 @@ public:
         dataset_info_(dataset_info),
         params_(params),
         gp_(gp),
+        frozen_indices_(gp),
         support_(dataset_info, params),
         contig_name_generator_(MakeContigNameGenerator(params_.mode, gp)),
         writer_(gp.g, contig_name_generator_),
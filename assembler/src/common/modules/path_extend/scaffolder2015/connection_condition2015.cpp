@@ -224,9 +224,22 @@ int PairedLibConnectionCondition::GetMedianGap(debruijn_graph::EdgeId e1, debrui
 
 AssemblyGraphConnectionCondition::AssemblyGraphConnectionCondition(const debruijn_graph::Graph &g,
                                                                    size_t max_connection_length,
-                                                                   const ScaffoldingUniqueEdgeStorage &unique_edges) :
+                                                                   const ScaffoldingUniqueEdgeStorage &unique_edges,
+                                                                   const Layout *layout) :
         g_(g), max_connection_length_(max_connection_length),
-        interesting_edge_set_(unique_edges.unique_edges()), stored_distances_() {
+        interesting_edge_set_(unique_edges.unique_edges()), stored_distances_(), layout_(layout) {
+}
+
+template<class DijkstraT>
+void AssemblyGraphConnectionCondition::AddReachedConnections(DijkstraT &dijkstra, EdgeId e) const {
+    dijkstra.Run(g_.EdgeEnd(e));
+    for (auto v: dijkstra.ReachedVertices()) {
+        for (auto connected: g_.OutgoingEdges(v)) {
+            if (interesting_edge_set_.find(connected) != interesting_edge_set_.end() && dijkstra.GetDistance(v) < max_connection_length_) {
+                stored_distances_[e].emplace(connected, 1);
+            }
+        }
+    }
 }
 
 Connections AssemblyGraphConnectionCondition::ConnectedWith(debruijn_graph::EdgeId e) const {
@@ -241,14 +254,13 @@ Connections AssemblyGraphConnectionCondition::ConnectedWith(debruijn_graph::Edge
             stored_distances_[e].emplace(connected, 1);
         }
     }
-    auto dijkstra = DijkstraHelper<debruijn_graph::Graph>::CreateBoundedDijkstra(g_, max_connection_length_);
-    dijkstra.Run(g_.EdgeEnd(e));
-    for (auto v: dijkstra.ReachedVertices()) {
-        for (auto connected: g_.OutgoingEdges(v)) {
-            if (interesting_edge_set_.find(connected) != interesting_edge_set_.end() && dijkstra.GetDistance(v) < max_connection_length_) {
-                stored_distances_[e].emplace(connected, 1);
-            }
-        }
+    if (layout_ && !layout_->stale()) {
+        auto dijkstra = DijkstraHelper<debruijn_graph::Graph>::CreateCompactBoundedDijkstra(g_, *layout_,
+                                                                                            max_connection_length_);
+        AddReachedConnections(dijkstra, e);
+    } else {
+        auto dijkstra = DijkstraHelper<debruijn_graph::Graph>::CreateBoundedDijkstra(g_, max_connection_length_);
+        AddReachedConnections(dijkstra, e);
     }
     return stored_distances_[e];
 }
@@ -130,14 +130,22 @@ public:
 */
 class AssemblyGraphConnectionCondition : public ConnectionCondition {
 protected:
+    typedef omnigraph::CompactGraphLayout<Graph> Layout;
+
     const Graph &g_;
 //Maximal gap to the connection.
     size_t max_connection_length_;
     EdgeSet interesting_edge_set_;
     mutable std::map<EdgeId, Connections> stored_distances_;
+//Optional, dijkstra runs over it while it is up to date
+    const Layout *layout_;
+
+    template<class DijkstraT>
+    void AddReachedConnections(DijkstraT &dijkstra, EdgeId e) const;
 public:
     AssemblyGraphConnectionCondition(const Graph &g, size_t max_connection_length,
-                                     const ScaffoldingUniqueEdgeStorage &unique_edges);
+                                     const ScaffoldingUniqueEdgeStorage &unique_edges,
+                                     const Layout *layout = nullptr);
     void AddInterestingEdges(func::TypedPredicate<typename Graph::EdgeId> edge_condition);
     Connections ConnectedWith(EdgeId e) const override;
     size_t GetLibIndex() const override;
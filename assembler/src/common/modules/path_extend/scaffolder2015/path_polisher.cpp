@@ -94,7 +94,7 @@ Gap DijkstraGapCloser::CloseGap(EdgeId target_edge, const Gap &orig_gap, Bidirec
     VertexId target_vertex = g_.EdgeStart(target_edge);
 //TODO:: actually we do not need paths, only edges..
     omnigraph::PathStorageCallback<Graph> path_storage(g_);
-    int process_res = omnigraph::ProcessPaths(g_, 0,
+    int process_res = omnigraph::ProcessPaths(g_, layout_, 0,
                             max_path_len_,
                             g_.EdgeEnd(result.Back()),
                             target_vertex,
@@ -295,7 +295,7 @@ Gap MatePairGapCloser::CloseGap(EdgeId target_edge, const Gap &orig_gap, Bidirec
         DEBUG("Closing gap with mate pairs between edge " << g_.int_id(last_e)
                   << " and edge " << g_.int_id(target_edge) << " was " << orig_gap);
         omnigraph::PathStorageCallback<Graph> path_storage(g_);
-        int process_res = omnigraph::ProcessPaths(g_, 0,
+        int process_res = omnigraph::ProcessPaths(g_, layout_, 0,
                                 max_path_len_,
                                 last_v,
                                 target_vertex,
@@ -41,6 +41,11 @@ public:
 //Intermediate abstract class - majority of GapClosers needs only one next edge after gap, not all original path.
 class TargetEdgeGapCloser : public PathGapCloser {
 protected:
+    typedef omnigraph::CompactGraphLayout<Graph> Layout;
+
+    // Optional, paths between the edges are searched over it while it is up to date
+    const Layout *layout_;
+
     //returns updated gap to target edge
     virtual Gap CloseGap(EdgeId target_edge, const Gap &gap, BidirectionalPath &path) const = 0;
 
@@ -50,8 +55,8 @@ protected:
     }
 
 public:
-    TargetEdgeGapCloser(const Graph& g, size_t max_path_len):
-            PathGapCloser(g, max_path_len) {}
+    TargetEdgeGapCloser(const Graph& g, size_t max_path_len, const Layout *layout = nullptr):
+            PathGapCloser(g, max_path_len), layout_(layout) {}
 
 };
 
@@ -85,8 +90,9 @@ protected:
 public:
     MatePairGapCloser(const Graph &g, size_t max_path_len,
                       const std::shared_ptr<PairedInfoLibrary> lib,
-                      const ScaffoldingUniqueEdgeStorage &storage):
-            TargetEdgeGapCloser(g, max_path_len), lib_(lib), storage_(storage) {}
+                      const ScaffoldingUniqueEdgeStorage &storage,
+                      const Layout *layout = nullptr):
+            TargetEdgeGapCloser(g, max_path_len, layout), lib_(lib), storage_(storage) {}
 };
 
 //TODO switch to a different Callback, no need to store all paths
@@ -113,8 +119,8 @@ protected:
     DECL_LOGGER("DijkstraGapCloser")
 
 public:
-    DijkstraGapCloser(const Graph& g, size_t max_path_len):
-        TargetEdgeGapCloser(g, max_path_len) {}
+    DijkstraGapCloser(const Graph& g, size_t max_path_len, const Layout *layout = nullptr):
+        TargetEdgeGapCloser(g, max_path_len, layout) {}
 
 };
 
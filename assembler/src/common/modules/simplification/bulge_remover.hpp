@@ -241,7 +241,52 @@ public:
     }
 
     std::vector<EdgeId> operator()(EdgeId e) const {
+        return Analyze(e, nullptr);
+    }
+
+    /**
+     * Same as operator(), additionally reports the vertices, modification of
+     * which may change the result
+     */
+    std::vector<EdgeId> operator()(EdgeId e, std::vector<VertexId> &neighbourhood) const {
+        return Analyze(e, &neighbourhood);
+    }
+
+    double max_coverage() const {
+        return max_coverage_;
+    }
+
+    size_t max_length() const {
+        return max_length_;
+    }
+
+private:
+    /**
+     * Collects the vertices the analysis of the edge depended on: the ones
+     * reached by the search of alternatives together with their neighbours
+     */
+    void CollectNeighbourhood(EdgeId e, const PathProcessor<Graph> *processor,
+                              std::vector<VertexId> &neighbourhood) const {
+        neighbourhood.clear();
+        neighbourhood.push_back(g_.EdgeStart(e));
+        neighbourhood.push_back(g_.EdgeEnd(e));
+        if (processor) {
+            for (VertexId v : processor->dijkstra().ReachedVertices()) {
+                neighbourhood.push_back(v);
+                for (EdgeId out : g_.OutgoingEdges(v))
+                    neighbourhood.push_back(g_.EdgeEnd(out));
+                for (EdgeId in : g_.IncomingEdges(v))
+                    neighbourhood.push_back(g_.EdgeStart(in));
+            }
+        }
+        std::sort(neighbourhood.begin(), neighbourhood.end());
+        neighbourhood.erase(std::unique(neighbourhood.begin(), neighbourhood.end()), neighbourhood.end());
+    }
+
+    std::vector<EdgeId> Analyze(EdgeId e, std::vector<VertexId> *neighbourhood) const {
         if (g_.length(e) > max_length_ || math::gr(g_.coverage(e), max_coverage_)) {
+            if (neighbourhood)
+                CollectNeighbourhood(e, nullptr, *neighbourhood);
             return EmptyPath();
         }
 
@@ -261,6 +306,8 @@ public:
         PathProcessor<Graph> processor(g_, start, max_path_len, dijkstra_vertex_limit_);
         processor.Process(end, (g_.length(e) > delta) ? g_.length(e) - delta : 0,
                           max_path_len, path_chooser, max_edge_cnt_);
+        if (neighbourhood)
+            CollectNeighbourhood(e, &processor, *neighbourhood);
 
         const std::vector<EdgeId> &path = path_chooser.most_covered_path();
         if (!path.empty()) {
@@ -285,15 +332,6 @@ public:
         }
     }
 
-    double max_coverage() const {
-        return max_coverage_;
-    }
-
-    size_t max_length() const {
-        return max_length_;
-    }
-
-private:
     DECL_LOGGER("AlternativesAnalyzer");
 };
 
@@ -388,7 +426,8 @@ private:
     typedef InterestingFinderPtr<Graph, EdgeId> CandidateFinderPtr;
     typedef SmartSetIterator<Graph, EdgeId, CoverageComparator<Graph>> SmartEdgeSet;
     typedef phmap::flat_hash_set<EdgeId> EdgeSet;
-    
+    typedef phmap::flat_hash_set<VertexId> VertexSet;
+
     size_t buff_size_;
     double buff_cov_diff_;
     double buff_cov_rel_diff_;
@@ -400,84 +439,44 @@ private:
 
     SmartEdgeSet it_;
 
-    static std::vector<EdgeId> EmptyPath() {
-        return {};
-    }
-
-    struct BulgeInfo : private boost::noncopyable {
-        size_t id;
+    struct BulgeInfo {
         EdgeId e;
         std::vector<EdgeId> alternative;
+        //vertices the alternative search depended on, sorted
+        std::vector<VertexId> neighbourhood;
 
-        BulgeInfo() :
-            id(-1ul) {
-        }
-
-        //passing by value is not a mistake!
-        BulgeInfo(size_t id_, EdgeId e_, std::vector<EdgeId> alternative_) :
-            id(id_), e(e_), alternative(std::move(alternative_)) {
-
-        }
-
-        BulgeInfo(BulgeInfo&& that) {
-            *this = std::move(that);
-        }
-
-        BulgeInfo& operator= (BulgeInfo&& that) {
-            id = that.id;
-            e = that.e;
-            alternative = std::move(that.alternative);
-            return *this;
-        }
-
-//        BulgeInfo(size_t id_, EdgeId e_, std::vector<EdgeId>&& alternative_) :
-//            id(id_), e(e_), alternative(std::move(alternative_)) {
-//
-//        }
-//
-        bool operator< (const BulgeInfo& that) const {
-//            VERIFY_MSG(id != that.id, "Ooops " << id);
-            return id < that.id;
+        BulgeInfo(EdgeId e_ = EdgeId()) :
+            e(e_) {
         }
 
         std::string str(const Graph& g) const {
             std::stringstream ss;
-            ss << "BulgeInfo " << id
-                    << " e: " << g.str(e)
+            ss << "BulgeInfo e: " << g.str(e)
                     << " path: " << PrintPath(g, alternative);
             return ss.str();
         }
-
     };
 
-    SmartEdgeSet AsSmartSet(const std::vector<EdgeId> &edges) {
-        SmartEdgeSet smart_set(this->g(), false, CoverageComparator<Graph>(this->g()));
-        smart_set.insert(edges.begin(), edges.end());
-        return smart_set;
-    }
-
-    bool CheckInteracting(const BulgeInfo &info, const EdgeSet &involved_edges) const {
-        if (involved_edges.count(info.e))
-            return true;
-        for (EdgeId e : info.alternative)
-            if (involved_edges.count(e))
-                return true;
-        return false;
+    void AccountVertex(VertexId v, VertexSet& modified_vertices) const {
+        modified_vertices.insert(v);
+        modified_vertices.insert(this->g().conjugate(v));
     }
 
-    void AccountEdge(EdgeId e, EdgeSet& involved_edges) const {
-        TRACE("Pushing edge " << this->g().str(e));
-        involved_edges.insert(e);
-        EdgeId conj = this->g().conjugate(e);
-        TRACE("Pushing edge " << this->g().str(conj));
-        involved_edges.insert(conj);
+    //vertices, incident edges of which are changed by gluing the bulge
+    void AccountModification(EdgeId e, const std::vector<EdgeId> &alternative, VertexSet& modified_vertices) const {
+        AccountVertex(this->g().EdgeStart(e), modified_vertices);
+        AccountVertex(this->g().EdgeEnd(e), modified_vertices);
+        for (EdgeId alt : alternative)
+            AccountVertex(this->g().EdgeEnd(alt), modified_vertices);
     }
 
-    void AccountEdges(const BulgeInfo& info, EdgeSet& involved_edges) const {
-        AccountEdge(info.e, involved_edges);
-        for (EdgeId e : info.alternative) {
-            AccountEdge(e, involved_edges);
-        }
+    bool CheckInteracting(const BulgeInfo &info, const VertexSet &modified_vertices) const {
+        if (modified_vertices.empty())
+            return false;
+        for (VertexId v : info.neighbourhood)
+            if (modified_vertices.count(v))
+                return true;
+        return false;
     }
 
     //returns false if time to stop
@@ -522,109 +521,80 @@ private:
         return !exhausted;
     }
 
-    std::vector<std::vector<BulgeInfo>> FindBulges(const std::vector<EdgeId>& edge_buffer) const {
+    //serial processing of the buffer in order
+    size_t BasicProcessBulges(const std::vector<EdgeId>& edge_buffer) {
+        auto alive = make_smart_container<EdgeSet>(this->g());
+        alive.insert(edge_buffer.begin(), edge_buffer.end());
+
+        size_t triggered = 0;
+        for (EdgeId e : edge_buffer) {
+            if (!alive.count(e))
+                continue;
+            TRACE("Processing edge " << this->g().str(e));
+            std::vector<EdgeId> alternative = alternatives_analyzer_(e);
+            if (!alternative.empty()) {
+                gluer_(e, alternative);
+                triggered++;
+            }
+        }
+        return triggered;
+    }
+
+    std::vector<BulgeInfo> FindBulges(const std::vector<EdgeId>& edge_buffer) const {
         DEBUG("Looking for bulges in parallel");
         utils::perf_counter perf;
-        std::vector<std::vector<BulgeInfo>> bulge_buffers(omp_get_max_threads());
         const size_t n = edge_buffer.size();
-        //order is in agreement with coverage
+        std::vector<BulgeInfo> bulges(n);
         DEBUG("Edge buffer size " << n);
         #pragma omp parallel for schedule(guided)
         for (size_t i = 0; i < n; ++i) {
-            EdgeId e = edge_buffer[i];
-            auto alternative = alternatives_analyzer_(e);
-            if (!alternative.empty()) {
-                bulge_buffers[omp_get_thread_num()].push_back(BulgeInfo(i, e, std::move(alternative)));
-            }
+            BulgeInfo &info = bulges[i];
+            info.e = edge_buffer[i];
+            info.alternative = alternatives_analyzer_(info.e, info.neighbourhood);
         }
         DEBUG("Bulges found (in parallel) in " << perf.time() << " seconds");
-        return bulge_buffers;
-    }
-
-    std::vector<BulgeInfo> MergeBuffers(std::vector<std::vector<BulgeInfo>>&& buffers) const {
-        DEBUG("Merging bulge buffers");
-        utils::perf_counter perf;
-
-        std::vector<BulgeInfo> merged_bulges;
-        for (auto& bulge_buffer : buffers) {
-            std::copy(std::make_move_iterator(bulge_buffer.begin()),
-                      std::make_move_iterator(bulge_buffer.end()),
-                      std::back_inserter(merged_bulges));
-        }
-
-        DEBUG("Sorting");
-        //order is in agreement with coverage
-        std::sort(merged_bulges.begin(), merged_bulges.end());
-        DEBUG("Total bulges " << merged_bulges.size());
-        DEBUG("Buffers merged in " << perf.time() << " seconds");
-        return merged_bulges;
+        return bulges;
     }
 
-    SmartEdgeSet RetainIndependentBulges(std::vector<BulgeInfo>& bulges) const {
-        DEBUG("Looking for independent bulges");
-        size_t total_cnt = bulges.size();
+    /**
+     * Glues the bulges in the buffer order. Analysis results that could have
+     * been affected by the preceding gluings (the modified vertices fall into
+     * the neighbourhood the search depended on) are recomputed, so the outcome
+     * is identical to the serial processing of the buffer.
+     */
+    size_t ProcessBulges(std::vector<BulgeInfo>& bulges) {
+        DEBUG("Processing bulges");
         utils::perf_counter perf;
 
-        std::vector<BulgeInfo> filtered;
-        filtered.reserve(bulges.size());
-        //fixme switch to involved vertices to bring fully parallel glueing closer
-        EdgeSet involved_edges;
-        SmartEdgeSet interacting_edges(this->g(), false, CoverageComparator<Graph>(this->g()));
+        auto alive = make_smart_container<EdgeSet>(this->g());
+        for (const BulgeInfo& info : bulges)
+            alive.insert(info.e);
 
+        size_t triggered = 0, reanalyzed = 0;
+        VertexSet modified_vertices;
         for (BulgeInfo& info : bulges) {
-            TRACE("Analyzing interactions of " << info.str(this->g()));
-            if (CheckInteracting(info, involved_edges)) {
-                TRACE("Interacting");
-                interacting_edges.push(info.e);
-            } else {
-                TRACE("Independent");
-                AccountEdges(info, involved_edges);
-                filtered.push_back(std::move(info));
+            if (!alive.count(info.e)) {
+                TRACE("Edge " << info.e << " was removed");
+                continue;
             }
-        }
-        bulges = std::move(filtered);
-
-        DEBUG("Independent bulges identified in " << perf.time() << " seconds");
-        DEBUG("Independent cnt " << bulges.size());
-        DEBUG("Interacting cnt " << interacting_edges.size());
-        VERIFY(bulges.size() + interacting_edges.size() == total_cnt);
-
-        return interacting_edges;
-    }
 
-    size_t BasicProcessBulges(SmartEdgeSet& edges) {
-        size_t triggered = 0;
-        //usual br strategy
-        for (; !edges.IsEnd(); ++edges) {
-            EdgeId e = *edges;
-            TRACE("Processing edge " << this->g().str(e));
-            std::vector<EdgeId> alternative = alternatives_analyzer_(e);
-            if (!alternative.empty()) {
-                gluer_(e, alternative);
-                triggered++;
+            if (CheckInteracting(info, modified_vertices)) {
+                TRACE("Interacting, reanalyzing edge " << this->g().str(info.e));
+                info.alternative = alternatives_analyzer_(info.e);
+                reanalyzed += 1;
             }
-        }
-        return triggered;
-    }
-
-    size_t ProcessBulges(const std::vector<BulgeInfo>& independent_bulges, SmartEdgeSet& interacting_edges) {
-        DEBUG("Processing bulges");
-        utils::perf_counter perf;
 
-        size_t triggered = 0;
+            if (info.alternative.empty())
+                continue;
 
-        for (const BulgeInfo& info : independent_bulges) {
             TRACE("Processing bulge " << info.str(this->g()));
-            triggered++;
+            AccountModification(info.e, info.alternative, modified_vertices);
             gluer_(info.e, info.alternative);
+            triggered += 1;
         }
 
-        DEBUG("Independent bulges glued in " << perf.time() << " seconds");
-        perf.reset();
-
-        DEBUG("Processing remaining interacting bulges " << interacting_edges.size());
-        triggered += BasicProcessBulges(interacting_edges);
-        DEBUG("Interacting edges processed in " << perf.time() << " seconds");
+        DEBUG("Bulges glued in " << perf.time() << " seconds");
+        DEBUG("Glued " << triggered << ", reanalyzed " << reanalyzed << " of " << bulges.size());
         return triggered;
     }
 
@@ -695,14 +665,11 @@ public:
             if (edge_buffer.size() < SMALL_BUFFER_THR) {
                 DEBUG("Processing small buffer");
                 utils::perf_counter perf;
-                //TODO implement via moves?
-                auto edges = AsSmartSet(edge_buffer);
-                inner_triggered = BasicProcessBulges(edges);
+                inner_triggered = BasicProcessBulges(edge_buffer);
                 DEBUG("Small buffer processed in " << perf.time() << " seconds");
             } else {
-                auto bulges = MergeBuffers(FindBulges(edge_buffer));
-                auto interacting_edges = RetainIndependentBulges(bulges);
-                inner_triggered = ProcessBulges(bulges, interacting_edges);
+                auto bulges = FindBulges(edge_buffer);
+                inner_triggered = ProcessBulges(bulges);
             }
 
             proceed |= (inner_triggered > 0);
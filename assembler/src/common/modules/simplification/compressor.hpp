@@ -1,6 +1,8 @@
 #pragma once
 #include "assembly_graph/graph_support/parallel_processing.hpp"
 #include "assembly_graph/graph_support/basic_vertex_conditions.hpp"
+
+#include <unordered_set>
 namespace omnigraph {
 
 /**
@@ -17,7 +19,7 @@ class Compressor {
     ConditionT compress_condition_;
     bool safe_merging_;
 
-    bool GoUniqueWayForward(EdgeId &e) {
+    bool GoUniqueWayForward(EdgeId &e) const {
         VertexId u = graph_.EdgeEnd(e);
         if (!graph_.CheckUniqueOutgoingEdge(u)
             || !graph_.CheckUniqueIncomingEdge(u)) {
@@ -27,7 +29,7 @@ class Compressor {
         return true;
     }
 
-    bool GoUniqueWayBackward(EdgeId &e) {
+    bool GoUniqueWayBackward(EdgeId &e) const {
         VertexId u = graph_.EdgeStart(e);
         if (!graph_.CheckUniqueOutgoingEdge(u)
             || !graph_.CheckUniqueIncomingEdge(u)) {
@@ -45,21 +47,43 @@ class Compressor {
                && !graph_.RelatedVertices(graph_.EdgeStart(e),
                                           graph_.EdgeEnd(e))) {
         }
+        EdgeId new_edge = graph_.MergePath(CollectChain(e), safe_merging_);
+        TRACE("Vertex compressed and is now part of edge "
+              << graph_.str(new_edge));
+        return new_edge;
+
+    }
+
+public:
+    /**
+     * Collects the non-branching path going forward from the given edge.
+     */
+    std::vector<EdgeId> CollectChain(EdgeId start_edge) const {
         std::vector<EdgeId> mergeList;
-        start_edge = e;
+        EdgeId e = start_edge;
         do {
             mergeList.push_back(e);
         } while (GoUniqueWayForward(e) && e != start_edge
                  && !graph_.RelatedVertices(graph_.EdgeStart(e),
                                             graph_.EdgeEnd(e)));
-        EdgeId new_edge = graph_.MergePath(mergeList, safe_merging_);
-        TRACE("Vertex compressed and is now part of edge "
-              << graph_.str(new_edge));
-        return new_edge;
+        return mergeList;
+    }
 
+    /**
+     * Checks if the compressible vertex is the first one of its chain, i.e. if the path merged
+     * by CompressVertex(v) starts with the edge incoming to v.
+     */
+    bool IsChainStart(VertexId v) const {
+        EdgeId e = graph_.GetUniqueIncomingEdge(v);
+        if (graph_.RelatedVertices(graph_.EdgeStart(e), graph_.EdgeEnd(e)))
+            return true;
+        return !GoUniqueWayBackward(e);
+    }
+
+    bool CanCompress(VertexId v) const {
+        return compress_condition_.Check(v);
     }
 
-public:
     Compressor(Graph& graph, bool safe_merging = true) :
             graph_(graph),
             compress_condition_(graph),
@@ -114,12 +138,129 @@ protected:
     }
 };
 
+/**
+* Bulk compression: maximal non-branching chains are collected in parallel, then they are processed
+* in blocks of bounded total length: merged sequences of a block are built in parallel and the chains
+* of the block are merged one by one, with a single merge notification per chain.
+* Chains without a start vertex (isolated cycles) or overlapping with other chains are left
+* to the regular compressor.
+*/
+template<class Graph>
+class BulkCompressor {
+    typedef typename Graph::EdgeId EdgeId;
+    typedef typename Graph::VertexId VertexId;
+    typedef typename Graph::EdgeData EdgeData;
+    typedef std::vector<EdgeId> Chain;
+
+    //bounds the total length of merged sequences, which are built, but not yet applied
+    static const size_t MAX_BLOCK_LENGTH = 1 << 26;
+
+    Graph &graph_;
+    Compressor<Graph> compressor_;
+    bool safe_merging_;
+
+    bool IsCanonical(const std::vector<EdgeId> &chain) const {
+        return !(graph_.conjugate(chain.back()) < chain.front());
+    }
+
+    void CollectChains(VertexId v, std::vector<Chain> &chains) const {
+        if (!compressor_.CanCompress(v) || !compressor_.IsChainStart(v))
+            return;
+        auto chain = compressor_.CollectChain(graph_.GetUniqueIncomingEdge(v));
+        if (!IsCanonical(chain))
+            return;
+
+        chains.push_back(graph_.CorrectMergePath(chain));
+    }
+
+    size_t Length(const Chain &chain) const {
+        size_t length = 0;
+        for (EdgeId e : chain)
+            length += graph_.length(e);
+        return length;
+    }
+
+    EdgeData MergedData(const Chain &chain) const {
+        std::vector<const EdgeData *> to_merge;
+        to_merge.reserve(chain.size());
+        for (EdgeId e : chain)
+            to_merge.push_back(&graph_.data(e));
+        return graph_.master().MergeData(to_merge, safe_merging_);
+    }
+
+    void MergeBlock(const std::vector<const Chain *> &block) {
+        std::vector<std::unique_ptr<EdgeData>> data(block.size());
+        #pragma omp parallel for schedule(guided)
+        for (size_t i = 0; i < block.size(); ++i)
+            data[i].reset(new EdgeData(MergedData(*block[i])));
+
+        for (size_t i = 0; i < block.size(); ++i) {
+            EdgeId new_edge = graph_.MergeCorrectedPath(*block[i], *data[i]);
+            TRACE("Chain compressed into edge " << graph_.str(new_edge));
+            data[i].reset();
+        }
+    }
+
+public:
+    BulkCompressor(Graph &graph, bool safe_merging = true)
+            : graph_(graph), compressor_(graph, safe_merging), safe_merging_(safe_merging) {}
+
+    size_t Run(size_t chunk_cnt) {
+        auto chunk_iterators = IterationHelper<Graph, VertexId>(graph_).Chunks(chunk_cnt);
+        std::vector<std::vector<Chain>> chains(chunk_iterators.size() - 1);
+        #pragma omp parallel for schedule(guided)
+        for (size_t i = 0; i < chunk_iterators.size() - 1; ++i) {
+            for (auto it = chunk_iterators[i], end = chunk_iterators[i + 1]; it != end; ++it)
+                CollectChains(*it, chains[i]);
+        }
+
+        //chains of a block do not overlap each other and the chains merged before,
+        //so their edges are intact till the block is merged
+        std::unordered_set<EdgeId> merged;
+        std::vector<const Chain *> block;
+        size_t block_length = 0;
+        size_t cnt = 0, skipped = 0;
+        for (const auto &chunk : chains) {
+            for (const auto &chain : chunk) {
+                bool overlaps = std::any_of(chain.begin(), chain.end(),
+                                            [&](EdgeId e) { return merged.count(e); });
+                if (overlaps) {
+                    skipped += 1;
+                    continue;
+                }
+                for (EdgeId e : chain) {
+                    merged.insert(e);
+                    merged.insert(graph_.conjugate(e));
+                }
+                block.push_back(&chain);
+                block_length += Length(chain);
+                cnt += 1;
+                if (block_length >= MAX_BLOCK_LENGTH) {
+                    MergeBlock(block);
+                    block.clear();
+                    block_length = 0;
+                }
+            }
+        }
+        MergeBlock(block);
+        DEBUG("Compressed " << cnt << " chains, " << skipped << " overlapping chains left");
+        return cnt;
+    }
+
+private:
+    DECL_LOGGER("BulkCompressor")
+};
+
 /**
 * Method compresses all vertices which can be compressed.
+* With several chunks the chains are first compressed in bulk mode, see BulkCompressor.
 */
 template<class Graph>
 size_t CompressAllVertices(Graph &g, size_t chunk_cnt = 1, bool safe_merging = true) {
+    size_t cnt = 0;
+    if (chunk_cnt > 1)
+        cnt += BulkCompressor<Graph>(g, safe_merging).Run(chunk_cnt);
     CompressingProcessor<Graph> compressor(g, chunk_cnt, safe_merging);
-    return compressor.Run();
+    return cnt + compressor.Run();
 }
 }
@@ -9,9 +9,14 @@
 #include "histogram.hpp"
 #include "histptr.hpp"
 
+#include "utils/parallel/openmp_wrapper.h"
+
 #include <btree/btree_map.h>
 #include <cuckoo/cuckoohash_map.hh>
 
+#include <algorithm>
+#include <vector>
+
 namespace omnigraph {
 
 namespace de {
@@ -112,9 +117,268 @@ class ConcurrentPairedBuffer : public PairedBufferBase<ConcurrentPairedBuffer<G,
     StorageMap storage_;
 };
 
+namespace impl {
+
+/**
+ * @brief Single parallel counting sort pass. Moves the records of all the sources into `dst`
+ *        grouped by `bucket(record)` (which should be less than `nbuckets`), the sources are released.
+ * @return Offsets of the buckets inside `dst`, nbuckets + 1 entries.
+ */
+template<class T, class BucketF>
+std::vector<size_t> RadixScatter(std::vector<std::vector<T>> &sources, std::vector<T> &dst,
+                                 size_t nbuckets, const BucketF &bucket) {
+    size_t nsources = sources.size();
+    std::vector<size_t> pos(nsources * nbuckets, 0);
+#   pragma omp parallel for schedule(dynamic)
+    for (size_t s = 0; s < nsources; ++s) {
+        size_t *cnt = pos.data() + s * nbuckets;
+        for (const T &r : sources[s])
+            cnt[bucket(r)] += 1;
+    }
+
+    // Buckets go one after another, inside the bucket the records of every source are contiguous
+    std::vector<size_t> offsets(nbuckets + 1, 0);
+    size_t total = 0;
+    for (size_t b = 0; b < nbuckets; ++b) {
+        offsets[b] = total;
+        for (size_t s = 0; s < nsources; ++s) {
+            size_t cnt = pos[s * nbuckets + b];
+            pos[s * nbuckets + b] = total;
+            total += cnt;
+        }
+    }
+    offsets[nbuckets] = total;
+
+    dst.resize(total);
+#   pragma omp parallel for schedule(dynamic)
+    for (size_t s = 0; s < nsources; ++s) {
+        size_t *cur = pos.data() + s * nbuckets;
+        for (const T &r : sources[s])
+            dst[cur[bucket(r)]++] = r;
+        std::vector<T>().swap(sources[s]);
+    }
+
+    return offsets;
+}
+
+}
+
+/**
+ * @brief Lock-free alternative to ConcurrentPairedBuffer. Every thread appends raw (e1, e2, point) records
+ *        of canonical edge pairs to its own log, so nothing is shared on the hot path. Histograms are
+ *        built only by Flush(): the logs are partitioned by the first edge in a parallel radix pass,
+ *        then the partitions are sorted and aggregated independently.
+ *        After Flush() the buffer can be merged or move-assigned into PairedIndex as the other buffers.
+ */
+template<typename G, typename Traits, template<typename, typename> class Container>
+class ThreadLocalPairedBuffer : public PairedBufferBase<ThreadLocalPairedBuffer<G, Traits, Container>,
+                                                        G, Traits> {
+    typedef ThreadLocalPairedBuffer<G, Traits, Container> self;
+    typedef PairedBufferBase<self, G, Traits> base;
+
+    friend class PairedBufferBase<self, G, Traits>;
+
+  protected:
+    using typename base::InnerPoint;
+    typedef omnigraph::de::Histogram<InnerPoint> InnerHistogram;
+    typedef omnigraph::de::StrongWeakPtr<InnerHistogram> InnerHistPtr;
+
+  public:
+    using typename base::Graph;
+    using typename base::EdgeId;
+    using typename base::EdgePair;
+    using typename base::Point;
+
+    typedef Container<EdgeId, InnerHistPtr> InnerMap;
+    typedef Container<EdgeId, InnerMap> StorageMap;
+
+  private:
+    struct Record {
+        EdgeId e1, e2;
+        InnerPoint p;
+
+        bool operator<(const Record &that) const {
+            if (e1 != that.e1)
+                return e1 < that.e1;
+            if (e2 != that.e2)
+                return e2 < that.e2;
+            return p < that.p;
+        }
+    };
+
+    struct Entry {
+        EdgeId e1, e2;
+        typename InnerHistPtr::pointer hist;
+        bool owning;
+
+        bool operator<(const Entry &that) const {
+            return std::make_pair(e1, e2) < std::make_pair(that.e1, that.e2);
+        }
+    };
+
+    typedef std::vector<Record> Log;
+
+    // Keep the vector headers of different threads in different cache lines
+    struct ThreadLog {
+        Log records;
+        size_t compact_limit = MIN_COMPACT_SIZE;
+        char padding[64];
+    };
+
+    // Logs are compacted in place when grown twice since the previous compaction
+    static const size_t MIN_COMPACT_SIZE = 1 << 20;
+
+    static void Compact(ThreadLog &log) {
+        Log &records = log.records;
+        std::sort(records.begin(), records.end());
+        auto out = records.begin();
+        for (auto it = records.begin() + 1; it != records.end(); ++it) {
+            if (out->e1 == it->e1 && out->e2 == it->e2 && !(out->p < it->p))
+                out->p = out->p + it->p;
+            else
+                *++out = *it;
+        }
+        records.erase(out + 1, records.end());
+        log.compact_limit = std::max(MIN_COMPACT_SIZE, 2 * records.size());
+    }
+
+  public:
+    ThreadLocalPairedBuffer(const Graph &g, size_t nthreads = omp_get_max_threads())
+            : base(g), logs_(nthreads) {
+        clear();
+    }
+
+    //---------------- Data inserting methods ----------------
+    /**
+     * @brief Appends a point between two edges to the log of the given thread.
+     *        Only one thread may use the same thread index at a time.
+     *        Points with the same distance are summed up when the log is compacted or flushed.
+     */
+    void Add(size_t thread, EdgeId e1, EdgeId e2, Point p) {
+        VERIFY(thread < logs_.size());
+        InnerPoint sp = Traits::Shrink(p, this->CalcOffset(e1));
+        EdgePair minep = this->MinMaxConjugatePair({ e1, e2 }).first;
+        ThreadLog &log = logs_[thread];
+        log.records.push_back({ minep.first, minep.second, sp });
+        if (this->IsSelfConj(e1, e2)) // This would double the weight of self-conjugate pairs
+            log.records.push_back({ minep.first, minep.second, sp });
+        if (log.records.size() >= log.compact_limit)
+            Compact(log);
+    }
+
+    //---------------- Miscellaneous ----------------
+
+    /**
+     * @brief Clears the whole buffer, including unflushed logs.
+     */
+    void clear() {
+        for (auto &log : logs_) {
+            Log().swap(log.records);
+            log.compact_limit = MIN_COMPACT_SIZE;
+        }
+        storage_.clear();
+        this->size_ = 0;
+    }
+
+    /**
+     * @brief Clears the buffer and sets the number of threads allowed to add points.
+     */
+    void clear(size_t nthreads) {
+        clear();
+        logs_.resize(nthreads);
+    }
+
+    /**
+     * @brief Turns the logged points into histograms. size() counts flushed points only.
+     *        Must not run concurrently with Add().
+     */
+    void Flush() {
+        size_t pending = 0;
+        std::vector<Log> logs(logs_.size());
+        for (size_t i = 0; i < logs_.size(); ++i) {
+            pending += logs_[i].records.size();
+            logs[i].swap(logs_[i].records);
+            logs_[i].compact_limit = MIN_COMPACT_SIZE;
+        }
+        if (!pending)
+            return;
+        VERIFY_MSG(storage_.empty(), "Buffer can be flushed only once, clear it before reuse");
+
+        const Graph &g = this->graph();
+        size_t nbuckets = 16 * std::max(size_t(omp_get_max_threads()), logs.size());
+        auto bucket = [&](const auto &r) { return size_t(g.int_id(r.e1)) % nbuckets; };
+
+        Log records;
+        auto offsets = impl::RadixScatter(logs, records, nbuckets, bucket);
+
+        // Aggregate every edge pair into a histogram. Conjugate views go to the bucket of the conjugate edge.
+        std::vector<std::vector<Entry>> entries(nbuckets);
+        size_t added = 0;
+#       pragma omp parallel for schedule(dynamic) reduction(+ : added)
+        for (size_t b = 0; b < nbuckets; ++b) {
+            auto first = records.begin() + offsets[b], last = records.begin() + offsets[b + 1];
+            std::sort(first, last);
+            for (auto it = first; it != last; ) {
+                EdgeId e1 = it->e1, e2 = it->e2;
+                auto hist = new InnerHistogram();
+                size_t points = 0;
+                for (; it != last && it->e1 == e1 && it->e2 == e2; ++it)
+                    points += hist->merge_point(it->p);
+
+                entries[b].push_back({ e1, e2, hist, /* owning */ true });
+                if (this->IsSelfConj(e1, e2)) {
+                    added += points;
+                } else {
+                    EdgePair conj = this->ConjugatePair(e1, e2);
+                    entries[b].push_back({ conj.first, conj.second, hist, /* owning */ false });
+                    added += 2 * points;
+                }
+            }
+        }
+        Log().swap(records);
+
+        std::vector<Entry> all_entries;
+        offsets = impl::RadixScatter(entries, all_entries, nbuckets, bucket);
+
+        std::vector<std::vector<std::pair<EdgeId, InnerMap>>> maps(nbuckets);
+#       pragma omp parallel for schedule(dynamic)
+        for (size_t b = 0; b < nbuckets; ++b) {
+            auto first = all_entries.begin() + offsets[b], last = all_entries.begin() + offsets[b + 1];
+            std::sort(first, last);
+            for (auto it = first; it != last; ++it) {
+                if (maps[b].empty() || maps[b].back().first != it->e1)
+                    maps[b].emplace_back(it->e1, InnerMap());
+                InnerMap &second = maps[b].back().second;
+                auto res = second.insert(std::make_pair(it->e2, InnerHistPtr(it->hist, it->owning)));
+                VERIFY_MSG(res.second, "Index insertion inconsistency");
+            }
+        }
+
+        for (auto &bucket_maps : maps)
+            for (auto &kvpair : bucket_maps)
+                storage_[kvpair.first] = std::move(kvpair.second);
+        this->size_ += added;
+    }
+
+    /**
+     * @brief Flushes the logs and exposes the histograms, e.g. for PairedIndex::MoveAssign.
+     */
+    typename StorageMap::locked_table lock_table() {
+        Flush();
+        return storage_.lock_table();
+    }
+
+  protected:
+    std::vector<ThreadLog> logs_;
+    StorageMap storage_;
+};
+
 template<class Graph>
 using ConcurrentPairedInfoBuffer = ConcurrentPairedBuffer<Graph, RawPointTraits, btree_map>;
 
+template<class Graph>
+using ThreadLocalPairedInfoBuffer = ThreadLocalPairedBuffer<Graph, RawPointTraits, btree_map>;
+
 } // namespace de
 
 } // namespace omnigraph
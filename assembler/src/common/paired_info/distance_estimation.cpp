@@ -15,20 +15,52 @@ std::vector<size_t> GraphDistanceFinder::GetGraphDistancesLengths(EdgeId e1, Edg
 }
 
 void GraphDistanceFinder::FillGraphDistancesLengths(EdgeId e1, LengthMap &second_edges) const {
-    std::vector<size_t> path_lower_bounds;
-    size_t path_upper_bound = PairInfoPathLengthUpperBound(graph_.k(), insert_size_, delta_);
-    PathProcessor <Graph> paths_proc(graph_, graph_.EdgeEnd(e1), path_upper_bound);
+    size_t path_upper_bound = PathLengthUpperBound();
+    VertexId start = graph_.EdgeEnd(e1);
+    if (layout_ && !layout_->stale()) {
+        typedef PathProcessor<Graph, DijkstraHelper<Graph>::CompactBoundedDijkstra> CompactPathProcessor;
+        FillGraphDistancesLengths<CompactPathProcessor>(e1, second_edges, [&]() {
+            return new CompactPathProcessor(graph_, start,
+                    DijkstraHelper<Graph>::CreateCompactBoundedDijkstra(graph_, *layout_, path_upper_bound,
+                                                                        PathProcessor<Graph>::MAX_DIJKSTRA_VERTICES));
+        });
+    } else {
+        FillGraphDistancesLengths<PathProcessor<Graph>>(e1, second_edges, [&]() {
+            return new PathProcessor<Graph>(graph_, start, path_upper_bound);
+        });
+    }
+}
+
+template<class Processor>
+void GraphDistanceFinder::FillGraphDistancesLengths(EdgeId e1, LengthMap &second_edges,
+                                                    const std::function<Processor*()> &create_processor) const {
+    size_t path_upper_bound = PathLengthUpperBound();
+    VertexId start = graph_.EdgeEnd(e1);
+    // Dijkstra from the start is launched only if some of the lengths are not cached
+    std::unique_ptr<Processor> paths_proc;
 
     for (auto &entry : second_edges) {
         EdgeId e2 = entry.first;
+        VertexId end = graph_.EdgeStart(e2);
         size_t path_lower_bound = PairInfoPathLengthLowerBound(graph_.k(), graph_.length(e1),
                                                                graph_.length(e2), gap_, delta_);
 
         TRACE("Bounds for paths are " << path_lower_bound << " " << path_upper_bound);
 
-        DistancesLengthsCallback<Graph> callback(graph_);
-        paths_proc.Process(graph_.EdgeStart(e2), path_lower_bound, path_upper_bound, callback);
-        GraphLengths lengths = callback.distances();
+        GraphLengths lengths;
+        if (!cache_ || !cache_->Find(start, end, lengths)) {
+            if (!paths_proc)
+                paths_proc.reset(create_processor());
+
+            // cached lengths are not restricted from below, the lower bound depends on the edges
+            DistancesLengthsCallback<Graph> callback(graph_);
+            paths_proc->Process(end, cache_ ? 0 : path_lower_bound, path_upper_bound, callback);
+            lengths = callback.distances();
+            if (cache_)
+                cache_->Insert(start, end, lengths);
+        }
+        lengths.erase(lengths.begin(), std::lower_bound(lengths.begin(), lengths.end(), path_lower_bound));
+
         for (size_t j = 0; j < lengths.size(); ++j) {
             lengths[j] += graph_.length(e1);
             TRACE("Resulting distance set for " <<
@@ -14,9 +14,12 @@
 #include "assembly_graph/paths/path_processor.hpp"
 
 #include "paired_info/pair_info_bounds.hpp"
+#include "paired_info/graph_distance_cache.hpp"
 #include "paired_info.hpp"
 #include "math/xmath.h"
 
+#include <functional>
+
 namespace omnigraph {
 
 namespace de {
@@ -28,21 +31,42 @@ class GraphDistanceFinder {
     typedef std::map<debruijn_graph::EdgeId, GraphLengths> LengthMap;
 
 public:
-    GraphDistanceFinder(const debruijn_graph::Graph &graph, size_t insert_size, size_t read_length, size_t delta) :
+    typedef CompactGraphLayout<debruijn_graph::Graph> Layout;
+
+    /**
+     * @param cache_memory_limit if nonzero, path lengths between vertex pairs are cached
+     * for the lifetime of the finder, taking up to this number of bytes
+     * @param layout if given and up to date, paths are searched over it instead of the graph
+     */
+    GraphDistanceFinder(const debruijn_graph::Graph &graph, size_t insert_size, size_t read_length, size_t delta,
+                        size_t cache_memory_limit = 0, const Layout *layout = nullptr) :
             graph_(graph), insert_size_(insert_size), gap_((int) (insert_size - 2 * read_length)),
-            delta_((double) delta) { }
+            delta_((double) delta), layout_(layout) {
+        if (cache_memory_limit)
+            cache_.reset(new GraphDistanceCache(cache_memory_limit));
+    }
 
     std::vector<size_t> GetGraphDistancesLengths(debruijn_graph::EdgeId e1, debruijn_graph::EdgeId e2) const;
 
     // finds all distances from a current edge to a set of edges
     void FillGraphDistancesLengths(debruijn_graph::EdgeId e1, LengthMap &second_edges) const;
 
+    size_t PathLengthUpperBound() const {
+        return PairInfoPathLengthUpperBound(graph_.k(), insert_size_, delta_);
+    }
+
 private:
+    template<class Processor>
+    void FillGraphDistancesLengths(debruijn_graph::EdgeId e1, LengthMap &second_edges,
+                                   const std::function<Processor*()> &create_processor) const;
+
     DECL_LOGGER("GraphDistanceFinder");
     const debruijn_graph::Graph &graph_;
     const size_t insert_size_;
     const int gap_;
     const double delta_;
+    std::unique_ptr<GraphDistanceCache> cache_;
+    const Layout *layout_;
 };
 
 class AbstractDistanceEstimator {
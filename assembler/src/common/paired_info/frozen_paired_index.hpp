@@ -0,0 +1,361 @@
+//***************************************************************************
+//* Copyright (c) 2019 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include "paired_info.hpp"
+#include "utils/parallel/openmp_wrapper.h"
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace omnigraph {
+
+namespace de {
+
+/**
+ * @brief Immutable snapshot of a paired index for read-only stages (e.g. repeat resolution).
+ *        Data is stored CSR-like: sorted first edges with offsets into the array of second edges,
+ *        which in turn has offsets into a single contiguous array of points. Conjugate pairs
+ *        keep their own copy of the points, so every neighbourhood is a plain contiguous range.
+ *        Provides the same query API as PairedIndex (Get, GetHalf, contains, HistProxy, EdgeProxy).
+ * @param G graph type
+ * @param Traits Policy-like structure with associated types of inner and resulting points
+ */
+template<typename G, typename Traits>
+class FrozenPairedIndex {
+    typedef FrozenPairedIndex<G, Traits> self;
+    typedef typename Traits::Gapped InnerPoint;
+    typedef uint64_t offset_t;
+
+  public:
+    typedef G Graph;
+    typedef typename Graph::EdgeId EdgeId;
+    typedef std::pair<EdgeId, EdgeId> EdgePair;
+    typedef typename Traits::Expanded Point;
+    typedef omnigraph::de::Histogram<Point> Histogram;
+
+    /**
+     * @brief Proxy set of points between two edges, see PairedIndex::HistProxy.
+     */
+    class HistProxy {
+      public:
+        class Iterator: public boost::iterator_facade<Iterator, Point, boost::random_access_traversal_tag, Point> {
+          public:
+            Iterator(const InnerPoint *ptr, DEDistance offset)
+                    : ptr_(ptr), offset_(offset) {}
+
+          private:
+            friend class boost::iterator_core_access;
+
+            Point dereference() const { return Traits::Expand(*ptr_, offset_); }
+            void increment() { ++ptr_; }
+            void decrement() { --ptr_; }
+            void advance(ptrdiff_t n) { ptr_ += n; }
+            ptrdiff_t distance_to(const Iterator &other) const { return other.ptr_ - ptr_; }
+            bool equal(const Iterator &other) const { return ptr_ == other.ptr_; }
+
+            const InnerPoint *ptr_;
+            DEDistance offset_;
+        };
+
+        HistProxy(const InnerPoint *begin = nullptr, const InnerPoint *end = nullptr, DEDistance offset = 0)
+                : begin_(begin), end_(end), offset_(offset) {}
+
+        Iterator begin() const { return Iterator(begin_, offset_); }
+        Iterator end() const { return Iterator(end_, offset_); }
+
+        /**
+         * @brief Finds the point with the minimal distance.
+         */
+        Point min() const {
+            VERIFY(!empty());
+            return *begin();
+        }
+
+        /**
+         * @brief Finds the point with the maximal distance.
+         */
+        Point max() const {
+            VERIFY(!empty());
+            return *--end();
+        }
+
+        /**
+         * @brief Returns the copy of all points in a simple flat histogram.
+         */
+        Histogram Unwrap() const {
+            return Histogram(begin(), end());
+        }
+
+        size_t size() const { return end_ - begin_; }
+        bool empty() const { return begin_ == end_; }
+
+      private:
+        const InnerPoint *begin_, *end_;
+        DEDistance offset_;
+    };
+
+    typedef typename HistProxy::Iterator HistIterator;
+
+    using EdgeHist = std::pair<EdgeId, HistProxy>;
+
+    /**
+     * @brief Proxy map of an edge neighbourhood, see PairedIndex::EdgeProxy.
+     */
+    class EdgeProxy {
+      public:
+        class Iterator: public boost::iterator_facade<Iterator, EdgeHist, boost::forward_traversal_tag, EdgeHist> {
+          public:
+            Iterator(const self &index, size_t pos, size_t stop, EdgeId edge, bool half)
+                    : index_(&index), pos_(pos), stop_(stop), edge_(edge), half_(half) {
+                Skip();
+            }
+
+          private:
+            friend class boost::iterator_core_access;
+
+            void Skip() { //For a half iterator, skip conjugate pairs
+                while (half_ && pos_ != stop_ && !index_->IsCanonical(edge_, index_->seconds_[pos_]))
+                    ++pos_;
+            }
+
+            void increment() {
+                ++pos_;
+                Skip();
+            }
+
+            bool equal(const Iterator &other) const {
+                return pos_ == other.pos_;
+            }
+
+            EdgeHist dereference() const {
+                return std::make_pair(index_->seconds_[pos_], index_->MakeProxy(edge_, pos_));
+            }
+
+            const self *index_;
+            size_t pos_, stop_;
+            EdgeId edge_;
+            bool half_;
+        };
+
+        EdgeProxy(const self &index, size_t begin, size_t end, EdgeId edge, bool half = false)
+                : index_(index), begin_(begin), end_(end), edge_(edge), half_(half) {}
+
+        Iterator begin() const { return Iterator(index_, begin_, end_, edge_, half_); }
+        Iterator end() const { return Iterator(index_, end_, end_, edge_, half_); }
+
+        HistProxy operator[](EdgeId e2) const {
+            if (half_ && !index_.IsCanonical(edge_, e2))
+                return HistProxy();
+            return index_.Get(edge_, e2);
+        }
+
+        bool empty() const { return begin_ == end_; }
+
+      private:
+        const self &index_;
+        size_t begin_, end_;
+        EdgeId edge_;
+        bool half_;
+    };
+
+    typedef typename EdgeProxy::Iterator EdgeIterator;
+
+    /**
+     * @brief Freezes the contents of a PairedIndex with the same point traits.
+     */
+    template<class Index>
+    explicit FrozenPairedIndex(const Index &index)
+            : graph_(index.graph()) {
+        std::vector<typename Index::ImplIterator> firsts;
+        for (auto it = index.data_begin(); it != index.data_end(); ++it) {
+            if (it->second.empty())
+                continue;
+            firsts.push_back(it);
+        }
+
+        firsts_.resize(firsts.size());
+        first_offsets_.assign(firsts.size() + 1, 0);
+        for (size_t i = 0; i < firsts.size(); ++i) {
+            firsts_[i] = firsts[i]->first;
+            first_offsets_[i + 1] = first_offsets_[i] + firsts[i]->second.size();
+        }
+
+        size_t pairs = first_offsets_.back();
+        seconds_.resize(pairs);
+        point_offsets_.assign(pairs + 1, 0);
+#       pragma omp parallel for schedule(guided)
+        for (size_t i = 0; i < firsts.size(); ++i) {
+            size_t pos = first_offsets_[i];
+            for (const auto &entry : firsts[i]->second) {
+                seconds_[pos] = entry.first;
+                point_offsets_[++pos] = entry.second->size();
+            }
+        }
+        for (size_t i = 0; i < pairs; ++i)
+            point_offsets_[i + 1] += point_offsets_[i];
+
+        points_.resize(point_offsets_.back());
+#       pragma omp parallel for schedule(guided)
+        for (size_t i = 0; i < firsts.size(); ++i) {
+            size_t pos = first_offsets_[i];
+            for (const auto &entry : firsts[i]->second)
+                std::copy(entry.second->begin(), entry.second->end(), points_.begin() + point_offsets_[pos++]);
+        }
+
+        VERIFY_DEV(points_.size() == index.size());
+    }
+
+    FrozenPairedIndex(FrozenPairedIndex &&) = default;
+
+    /**
+     * @brief Releases all the memory held by the index.
+     */
+    void clear() {
+        std::vector<EdgeId>().swap(firsts_);
+        std::vector<offset_t>().swap(first_offsets_);
+        std::vector<EdgeId>().swap(seconds_);
+        std::vector<offset_t>().swap(point_offsets_);
+        std::vector<InnerPoint>().swap(points_);
+    }
+
+    //---------------- Data accessing methods ----------------
+
+    /**
+     * @brief Returns a whole proxy map to the neighbourhood of some edge.
+     */
+    EdgeProxy Get(EdgeId e) const {
+        auto range = Neighbours(e);
+        return EdgeProxy(*this, range.first, range.second, e);
+    }
+
+    /**
+     * @brief Returns a half proxy map to the neighbourhood of some edge.
+     */
+    EdgeProxy GetHalf(EdgeId e) const {
+        auto range = Neighbours(e);
+        return EdgeProxy(*this, range.first, range.second, e, true);
+    }
+
+    /**
+     * @brief Operator alias of Get(id).
+     */
+    EdgeProxy operator[](EdgeId e) const {
+        return Get(e);
+    }
+
+    /**
+     * @brief Returns a histogram proxy for all points between two edges.
+     */
+    HistProxy Get(EdgeId e1, EdgeId e2) const {
+        size_t pos = Find(e1, e2);
+        if (pos == NOT_FOUND)
+            return HistProxy();
+        return MakeProxy(e1, pos);
+    }
+
+    /**
+     * @brief Operator alias of Get(e1, e2).
+     */
+    HistProxy operator[](EdgePair p) const {
+        return Get(p.first, p.second);
+    }
+
+    /**
+     * @brief Checks if an edge (or its conjugated twin) is consisted in the index.
+     */
+    bool contains(EdgeId edge) const {
+        return FindFirst(edge) != NOT_FOUND || FindFirst(graph_.conjugate(edge)) != NOT_FOUND;
+    }
+
+    /**
+     * @brief Checks if there is a histogram for two edges.
+     */
+    bool contains(EdgeId e1, EdgeId e2) const {
+        return Find(e1, e2) != NOT_FOUND;
+    }
+
+    //---------------- Miscellaneous ----------------
+
+    const Graph &graph() const { return graph_; }
+
+    /**
+     * @brief Returns the physical index size (total count of all points).
+     */
+    size_t size() const { return points_.size(); }
+
+    EdgePair ConjugatePair(EdgeId e1, EdgeId e2) const {
+        return std::make_pair(graph_.conjugate(e2), graph_.conjugate(e1));
+    }
+
+    bool IsCanonical(EdgeId e1, EdgeId e2) const {
+        auto ep = std::make_pair(e1, e2);
+        return ep <= ConjugatePair(e1, e2);
+    }
+
+    /**
+     * @brief Calls f(e1, e2, begin, end) for every stored pair of edges (including the conjugate ones)
+     *        with the range of its raw points. Used to restore the mutable index, see PairedBuffer::Thaw.
+     */
+    template<class F>
+    void ForEachRawHist(const F &f) const {
+        for (size_t i = 0; i < firsts_.size(); ++i)
+            for (size_t pos = first_offsets_[i]; pos < first_offsets_[i + 1]; ++pos)
+                f(firsts_[i], seconds_[pos],
+                  points_.data() + point_offsets_[pos], points_.data() + point_offsets_[pos + 1]);
+    }
+
+  private:
+    static const size_t NOT_FOUND = size_t(-1);
+
+    size_t FindFirst(EdgeId e) const {
+        auto it = std::lower_bound(firsts_.begin(), firsts_.end(), e);
+        if (it == firsts_.end() || *it != e)
+            return NOT_FOUND;
+        return it - firsts_.begin();
+    }
+
+    std::pair<size_t, size_t> Neighbours(EdgeId e) const {
+        size_t i = FindFirst(e);
+        if (i == NOT_FOUND)
+            return { 0, 0 };
+        return { first_offsets_[i], first_offsets_[i + 1] };
+    }
+
+    size_t Find(EdgeId e1, EdgeId e2) const {
+        auto range = Neighbours(e1);
+        auto b = seconds_.begin() + range.first, e = seconds_.begin() + range.second;
+        auto it = std::lower_bound(b, e, e2);
+        if (it == e || *it != e2)
+            return NOT_FOUND;
+        return it - seconds_.begin();
+    }
+
+    HistProxy MakeProxy(EdgeId e1, size_t pos) const {
+        return HistProxy(points_.data() + point_offsets_[pos], points_.data() + point_offsets_[pos + 1],
+                         DEDistance(graph_.length(e1)));
+    }
+
+    const Graph &graph_;
+    std::vector<EdgeId> firsts_;
+    std::vector<offset_t> first_offsets_;
+    std::vector<EdgeId> seconds_;
+    std::vector<offset_t> point_offsets_;
+    std::vector<InnerPoint> points_;
+};
+
+template<typename Graph>
+using FrozenPairedInfoIndexT = FrozenPairedIndex<Graph, PointTraits>;
+
+template<typename Graph>
+using FrozenUnclusteredPairedInfoIndexT = FrozenPairedIndex<Graph, RawPointTraits>;
+
+} // namespace de
+
+} // namespace omnigraph
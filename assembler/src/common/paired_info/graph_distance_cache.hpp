@@ -0,0 +1,120 @@
+//***************************************************************************
+//* Copyright (c) 2019 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include "assembly_graph/core/graph.hpp"
+#include "utils/logger/logger.hpp"
+
+#include <parallel_hashmap/phmap.h>
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace omnigraph {
+
+namespace de {
+
+// Concurrent cache of the sets of path lengths between pairs of vertices, all paths being
+// not longer than a fixed bound. The owner is responsible for keeping the bound fixed.
+// The table is split into independently locked shards. Memory use is capped: a shard
+// exceeding its share of the limit is flushed as a whole.
+class GraphDistanceCache {
+public:
+    typedef std::vector<size_t> GraphLengths;
+
+private:
+    typedef debruijn_graph::VertexId VertexId;
+
+    struct Shard {
+        std::mutex lock;
+        phmap::flat_hash_map<uint64_t, GraphLengths> lengths;
+        size_t memory = 0;
+    };
+
+    const size_t shard_memory_limit_;
+    std::vector<Shard> shards_;
+    std::atomic<size_t> hits_, misses_, flushes_;
+
+    static bool MakeKey(VertexId start, VertexId end, uint64_t &key) {
+        uint64_t start_id = start.int_id(), end_id = end.int_id();
+        if (start_id > std::numeric_limits<uint32_t>::max() || end_id > std::numeric_limits<uint32_t>::max())
+            return false;
+        key = (start_id << 32) | end_id;
+        return true;
+    }
+
+    Shard &GetShard(uint64_t key) {
+        //Fibonacci hashing, high bits are the best mixed
+        uint64_t h = key * 0x9E3779B97F4A7C15ull;
+        return shards_[(h >> 32) % shards_.size()];
+    }
+
+    static size_t EntryMemory(const GraphLengths &lengths) {
+        return sizeof(uint64_t) + sizeof(GraphLengths) + lengths.size() * sizeof(size_t);
+    }
+
+public:
+    /**
+     * @param memory_limit approximate limit on the memory taken by the stored lengths, in bytes
+     */
+    GraphDistanceCache(size_t memory_limit, size_t shard_cnt = 1024)
+            : shard_memory_limit_(memory_limit / shard_cnt),
+              shards_(shard_cnt),
+              hits_(0), misses_(0), flushes_(0) {}
+
+    ~GraphDistanceCache() {
+        DEBUG("Graph distance cache: " << hits_ << " hits, " << misses_ << " misses, "
+              << flushes_ << " shard flushes");
+    }
+
+    bool Find(VertexId start, VertexId end, GraphLengths &lengths) {
+        uint64_t key;
+        if (!MakeKey(start, end, key))
+            return false;
+
+        Shard &shard = GetShard(key);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        auto it = shard.lengths.find(key);
+        if (it == shard.lengths.end()) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        lengths = it->second;
+        return true;
+    }
+
+    void Insert(VertexId start, VertexId end, const GraphLengths &lengths) {
+        uint64_t key;
+        if (!MakeKey(start, end, key))
+            return;
+
+        size_t entry_memory = EntryMemory(lengths);
+        if (entry_memory > shard_memory_limit_)
+            return;
+
+        Shard &shard = GetShard(key);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        if (shard.memory + entry_memory > shard_memory_limit_) {
+            flushes_.fetch_add(1, std::memory_order_relaxed);
+            shard.lengths.clear();
+            shard.memory = 0;
+        }
+        if (shard.lengths.emplace(key, lengths).second)
+            shard.memory += entry_memory;
+    }
+
+private:
+    DECL_LOGGER("GraphDistanceCache");
+};
+
+}
+
+}
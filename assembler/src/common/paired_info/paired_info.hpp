@@ -656,6 +656,10 @@ public:
         }
     }
 
+    bool IsDeferrable() const override {
+        return true;
+    }
+
 
 };
 
@@ -209,6 +209,28 @@ class PairedBuffer : public PairedBufferBase<PairedBuffer<G, Traits, Container>,
         }
     }
 
+    /**
+     * @brief Refills the index from its frozen snapshot (see FrozenPairedIndex), restoring
+     *        the same histograms the snapshot was built from.
+     */
+    template<class Frozen>
+    void Thaw(const Frozen &frozen) {
+        clear();
+        frozen.ForEachRawHist([&](EdgeId e1, EdgeId e2, const InnerPoint *begin, const InnerPoint *end) {
+            if (!this->IsCanonical(e1, e2))
+                return;
+            auto hist = new InnerHistogram(begin, end);
+            storage_[e1][e2] = InnerHistPtr(hist, /* owning */ true);
+            bool selfconj = this->IsSelfConj(e1, e2);
+            this->size_ += hist->size() * (selfconj ? 1 : 2);
+            if (!selfconj) {
+                auto conj = this->ConjugatePair(e1, e2);
+                storage_[conj.first][conj.second] = InnerHistPtr(hist, /* owning */ false);
+            }
+        });
+        VERIFY_DEV(this->size_ == frozen.size());
+    }
+
     void BinRead(std::istream &str) {
         clear();
         using io::binary::BinRead;
@@ -702,6 +702,10 @@ void load_launch_info(debruijn_config &cfg, boost::property_tree::ptree const &p
     load(cfg.temp_bin_reads_dir, pt, "temp_bin_reads_dir");
     if (cfg.temp_bin_reads_dir[cfg.temp_bin_reads_dir.length() - 1] != '/')
         cfg.temp_bin_reads_dir += '/';
+    // Optional, binary reads are stored uncompressed by default
+    cfg.compress_bin_reads = pt.get("compress_bin_reads", false);
+    // Optional, edges own their sequences by default
+    cfg.edge_nucl_arena = pt.get("edge_nucl_arena", false);
 
     load(cfg.max_threads, pt, "max_threads");
     cfg.max_threads = spades_set_omp_threads(cfg.max_threads);
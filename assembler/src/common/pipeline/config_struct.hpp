@@ -488,6 +488,8 @@ struct debruijn_config {
     // Conversion options
     std::string temp_bin_reads_dir;
     std::string temp_bin_reads_path;
+    bool compress_bin_reads;
+    bool edge_nucl_arena;
     std::string paired_read_prefix;
     std::string single_read_prefix;
 
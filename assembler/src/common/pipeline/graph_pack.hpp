@@ -13,6 +13,7 @@
 #include "assembly_graph/handlers/id_track_handler.hpp"
 #include "assembly_graph/handlers/edges_position_handler.hpp"
 #include "assembly_graph/core/graph.hpp"
+#include "assembly_graph/core/compact_graph_layout.hpp"
 #include "paired_info/paired_info.hpp"
 #include "pipeline/config_struct.hpp"
 #include "modules/alignment/edge_index.hpp"
@@ -59,6 +60,7 @@ struct graph_pack: public adt::pack, private boost::noncopyable {
     EdgeQuality<Graph> &edge_qual;
     EdgesPositionHandler<graph_t> &edge_pos;
     ConnectedComponentCounter &components;
+    omnigraph::CompactGraphLayout<Graph> &compact_layout;
 
     path_extend::PathContainer &contig_paths;
 
@@ -84,6 +86,7 @@ struct graph_pack: public adt::pack, private boost::noncopyable {
               edge_qual(adt::pack::emplace<EdgeQuality<Graph>>(g)),
               edge_pos(adt::pack::emplace<EdgesPositionHandler<graph_t>>(g, max_mapping_gap + k, max_gap_diff)),
               components(adt::pack::emplace<ConnectedComponentCounter>(g)),
+              compact_layout(adt::pack::emplace<omnigraph::CompactGraphLayout<Graph>>(g)),
               contig_paths(adt::pack::emplace<path_extend::PathContainer>()) {
         if (detach_indices)
             DetachAll();
@@ -134,6 +137,15 @@ struct graph_pack: public adt::pack, private boost::noncopyable {
         visualization::position_filler::FillPos(*this, ReverseComplement(genome.str()), "ref1");
     }
 
+    // The layout stays attached, so it is rebuilt only if the graph was modified since the last call
+    void EnsureCompactLayout() {
+        if (!compact_layout.stale())
+            return;
+
+        INFO("Building compact graph layout");
+        compact_layout.Refresh();
+    }
+
     void EnsureDebugInfo() {
         EnsureBasicMapping();
         EnsureQuality();
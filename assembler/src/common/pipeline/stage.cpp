@@ -25,7 +25,8 @@ void AssemblyStage::load(debruijn_graph::conj_graph_pack& gp,
     INFO("Loading current state from " << dir);
 
     io::ConvertIfNeeded(cfg::get_writable().ds.reads,
-                        cfg::get().max_threads);
+                        cfg::get().max_threads,
+                        cfg::get().compress_bin_reads);
 
     auto p = fs::append_path(dir, "graph_pack");
     io::binary::FullPackIO<Graph>().Load(p, gp);
@@ -0,0 +1,123 @@
+//***************************************************************************
+//* Copyright (c) 2019 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include "sequence.hpp"
+#include "utils/parallel/openmp_wrapper.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Bump allocator of nucleotide sequences. Sequences placed into the arena
+ * share large 2-bit slabs instead of owning separate buffers. The arena owns
+ * the slabs and hands out non-owning views, so it must outlive everything
+ * placed there. Slabs are freed only by Reset() / ReleaseRetired() or with
+ * the arena itself. Placing is thread-safe, every thread fills its own slab.
+ */
+class NuclArena {
+    typedef seq_element_type ST;
+    typedef std::unique_ptr<ST[]> Slab;
+
+    // In nucleotides, 4 Mb per slab
+    static const size_t SLAB_SIZE = size_t(1) << 24;
+    static const size_t STN = (sizeof(ST) << 3) >> 1;
+
+    struct Cursor {
+        std::mutex lock;
+        ST *slab;
+        size_t pos;
+
+        Cursor() : slab(nullptr), pos(SLAB_SIZE) {}
+    };
+
+    std::unique_ptr<Cursor[]> cursors_;
+    size_t cursor_cnt_;
+    std::atomic<size_t> placed_;
+
+    std::mutex slabs_lock_;
+    std::vector<Slab> slabs_;
+    // Slabs preceding the last reset, still referenced until ReleaseRetired()
+    std::vector<Slab> retired_;
+
+    static size_t DataSize(size_t size) {
+        return (size + STN - 1) / STN;
+    }
+
+    ST *NewSlab(size_t words) {
+        Slab slab(new ST[words]);
+        ST *res = slab.get();
+        std::lock_guard<std::mutex> guard(slabs_lock_);
+        slabs_.push_back(std::move(slab));
+        return res;
+    }
+
+public:
+    NuclArena(size_t nthreads = omp_get_max_threads())
+            : cursors_(new Cursor[std::max(nthreads, size_t(1))]),
+              cursor_cnt_(std::max(nthreads, size_t(1))),
+              placed_(0) {}
+
+    /**
+     * @return view of the copy of s residing in the arena
+     */
+    SequenceView Place(const SequenceView &s) {
+        size_t words = DataSize(s.size());
+        placed_ += s.size();
+        // Long sequences do not fit into a slab and are not fragmenting the heap anyway
+        if (words * STN > SLAB_SIZE / 4) {
+            ST *data = NewSlab(words);
+            s.copy_data(data);
+            return SequenceView(data, 0, s.size(), false);
+        }
+
+        Cursor &cursor = cursors_[omp_get_thread_num() % cursor_cnt_];
+        std::lock_guard<std::mutex> guard(cursor.lock);
+        if (cursor.pos + words * STN > SLAB_SIZE) {
+            cursor.slab = NewSlab(SLAB_SIZE / STN);
+            cursor.pos = 0;
+        }
+
+        // Sequences start at word boundaries
+        SequenceView res(cursor.slab, cursor.pos, s.size(), false);
+        s.copy_data(cursor.slab + cursor.pos / STN);
+        cursor.pos += words * STN;
+        return res;
+    }
+
+    /**
+     * Starts new slabs. The old ones stay alive, so the sequences residing
+     * there can be placed again, until ReleaseRetired() is called.
+     */
+    void Reset() {
+        for (size_t i = 0; i < cursor_cnt_; ++i) {
+            std::lock_guard<std::mutex> guard(cursors_[i].lock);
+            cursors_[i].slab = nullptr;
+            cursors_[i].pos = SLAB_SIZE;
+        }
+        std::lock_guard<std::mutex> guard(slabs_lock_);
+        for (auto &slab : slabs_)
+            retired_.push_back(std::move(slab));
+        slabs_.clear();
+        placed_ = 0;
+    }
+
+    /**
+     * Frees the slabs retired by Reset(), all the views into them become invalid
+     */
+    void ReleaseRetired() {
+        std::lock_guard<std::mutex> guard(slabs_lock_);
+        std::vector<Slab>().swap(retired_);
+    }
+
+    // Total length of the sequences placed since the last reset
+    size_t placed() const {
+        return placed_;
+    }
+};
@@ -18,6 +18,8 @@
 #include <llvm/ADT/IntrusiveRefCntPtr.h>
 #include <llvm/Support/TrailingObjects.h>
 
+class SequenceView;
+
 class Sequence {
     // Type to store Seq in Sequences
     typedef seq_element_type ST;
@@ -149,6 +151,9 @@ public:
         InitFromNucls(s, rc);
     }
 
+    // Owning copy of the viewed nucleotides
+    inline explicit Sequence(const SequenceView &view);
+
     Sequence()
             : Sequence(size_t(0), 0) {
         memset(data_->data(), 0, DataSize(size_));
@@ -271,6 +276,8 @@ public:
         return size() == 0;
     }
 
+    inline SequenceView view() const;
+
     template<class Seq>
     bool contains(const Seq& s, size_t offset = 0) const {
         VERIFY_DEV(offset + s.size() <= size());
@@ -284,6 +291,8 @@ public:
 
 public:
     inline bool BinRead(std::istream &file);
+    // Decodes from memory [data, end), returns the position right after the sequence
+    inline const char *BinRead(const char *data, const char *end);
     inline bool BinWrite(std::ostream &file) const;
 };
 
@@ -421,6 +430,21 @@ bool Sequence::BinRead(std::istream &file) {
 }
 
 
+const char *Sequence::BinRead(const char *data, const char *end) {
+    VERIFY_MSG(size_t(end - data) >= sizeof(size_), "Truncated sequence header");
+    memcpy(&size_, data, sizeof(size_));
+    data += sizeof(size_);
+    from_ = 0;
+    rtl_ = false;
+
+    size_t bytes = DataSize(size_) * sizeof(ST);
+    VERIFY_MSG(size_t(end - data) >= bytes, "Truncated sequence of length " << size_);
+    data_ = llvm::IntrusiveRefCntPtr<ManagedNuclBuffer>(ManagedNuclBuffer::create(size_));
+    memcpy(data_->data(), data, bytes);
+
+    return data + bytes;
+}
+
 bool Sequence::BinWrite(std::ostream &file) const {
     if (from_ != 0 || rtl_) {
         Sequence clear(this->str());
@@ -434,6 +458,146 @@ bool Sequence::BinWrite(std::ostream &file) const {
     return !file.fail();
 }
 
+/**
+ * Non-owning view of 2-bit nucleotide data of a Sequence or of a NuclArena.
+ * Unlike Sequence copies, copies of the view do not touch any reference
+ * counter. The view is valid only while the viewed data is alive.
+ */
+class SequenceView {
+    typedef seq_element_type ST;
+    const static size_t STBits = sizeof(ST) << 3;
+    const static size_t STN = STBits >> 1;
+    const static size_t STNBits = log_<STN, 2>::value;
+
+    const ST *data_;
+    size_t from_;
+    size_t size_;
+    bool rtl_;
+
+public:
+    SequenceView(const ST *data, size_t from, size_t size, bool rtl)
+            : data_(data), from_(from), size_(size), rtl_(rtl) {}
+
+    char operator[](const size_t index) const {
+        VERIFY_DEV(index < size_);
+        if (rtl_) {
+            size_t i = from_ + size_ - 1 - index;
+            return complement((data_[i >> STNBits] >> ((i & (STN - 1)) << 1)) & 3);
+        } else {
+            size_t i = from_ + index;
+            return (data_[i >> STNBits] >> ((i & (STN - 1)) << 1)) & 3;
+        }
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    SequenceView operator!() const {
+        return SequenceView(data_, from_, size_, !rtl_);
+    }
+
+    SequenceView Subseq(size_t from, size_t to) const {
+        VERIFY(from <= to && to <= size_);
+        if (rtl_)
+            return SequenceView(data_, from_ + size_ - to, to - from, true);
+        return SequenceView(data_, from_ + from, to - from, false);
+    }
+
+    SequenceView Subseq(size_t from) const {
+        return Subseq(from, size_);
+    }
+
+    template<class Seq>
+    Seq start(size_t k) const {
+        return Seq(unsigned(k), *this);
+    }
+
+    template<class Seq>
+    Seq end(size_t k) const {
+        return Seq(unsigned(k), *this, size_ - k);
+    }
+
+    bool operator==(const SequenceView &that) const {
+        if (size_ != that.size_)
+            return false;
+        if (data_ == that.data_ && from_ == that.from_ && rtl_ == that.rtl_)
+            return true;
+        for (size_t i = 0; i < size_; ++i)
+            if (operator[](i) != that[i])
+                return false;
+        return true;
+    }
+
+    bool operator!=(const SequenceView &that) const {
+        return !operator==(that);
+    }
+
+    template<class Seq>
+    bool contains(const Seq& s, size_t offset = 0) const {
+        VERIFY_DEV(offset + s.size() <= size());
+
+        for (size_t i = 0, e = s.size(); i != e; ++i)
+            if (operator[](offset + i) != s[i])
+                return false;
+
+        return true;
+    }
+
+    /**
+     * Packs the nucleotides into DataSize(size()) words starting at dst,
+     * unused bits of the last word are zeroed
+     */
+    void copy_data(ST *dst) const {
+        if (!rtl_ && (from_ & (STN - 1)) == 0) {
+            size_t words = (size_ + STN - 1) >> STNBits;
+            memcpy(dst, data_ + (from_ >> STNBits), words * sizeof(ST));
+            if (size_ & (STN - 1))
+                dst[words - 1] &= (ST(1) << ((size_ & (STN - 1)) << 1)) - 1;
+            return;
+        }
+
+        ST data = 0;
+        size_t cnt = 0;
+        for (size_t i = 0; i < size_; ++i) {
+            data |= ST(operator[](i)) << cnt;
+            cnt += 2;
+            if (cnt == STBits) {
+                *dst++ = data;
+                cnt = 0;
+                data = 0;
+            }
+        }
+        if (cnt != 0)
+            *dst = data;
+    }
+
+    std::string str() const {
+        std::string res(size_, '-');
+        for (size_t i = 0; i < size_; ++i)
+            res[i] = nucl(operator[](i));
+        return res;
+    }
+};
+
+inline std::ostream &operator<<(std::ostream &os, const SequenceView &s) {
+    os << s.str();
+    return os;
+}
+
+SequenceView Sequence::view() const {
+    return SequenceView(data_->data(), from_, size_, rtl_);
+}
+
+Sequence::Sequence(const SequenceView &view)
+        : Sequence(view.size(), 0) {
+    view.copy_data(data_->data());
+}
+
 /**
  * @class SequenceBuilder
  * @section DESCRIPTION
@@ -461,6 +625,10 @@ public:
         return Sequence(buf_);
     }
 
+    void reserve(size_t size) {
+        buf_.reserve(size);
+    }
+
     size_t size() const {
         return buf_.size();
     }
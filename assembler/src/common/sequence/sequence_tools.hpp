@@ -40,7 +40,12 @@ inline const Sequence MergeOverlappingSequences(const std::vector<Sequence>& ss,
     if (ss.empty()) {
         return Sequence();
     }
+    size_t total = overlap;
+    for (const auto &s : ss)
+        total += s.size() - overlap;
+
     SequenceBuilder sb;
+    sb.reserve(total);
     Sequence prev_end = ss.front().Subseq(0, overlap);
     sb.append(prev_end);
     for (auto it = ss.begin(); it != ss.end(); ++it) {
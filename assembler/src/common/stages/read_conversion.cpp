@@ -11,7 +11,8 @@ namespace spades {
 
 void ReadConversion::run(debruijn_graph::conj_graph_pack &, const char *) {
     io::ConvertIfNeeded(cfg::get_writable().ds.reads,
-                        cfg::get().max_threads);
+                        cfg::get().max_threads,
+                        cfg::get().compress_bin_reads);
 }
 
 void ReadConversion::load(debruijn_graph::conj_graph_pack &,
@@ -478,6 +478,7 @@ void Simplification::run(conj_graph_pack &gp, const char*) {
                                printer);
     simplifier.SimplifyGraph();
     CompressAllVertices(gp.g);
+    gp.g.CompactNucls();
 }
 
 void SimplificationCleanup::run(conj_graph_pack &gp, const char*) {
@@ -490,6 +491,9 @@ void SimplificationCleanup::run(conj_graph_pack &gp, const char*) {
                                printer);
 
     simplifier.PostSimplification();
+    gp.g.CompactNucls();
+    // Read-only traversals of the following stages run over the frozen layout
+    gp.EnsureCompactLayout();
 
     DEBUG("Graph simplification finished");
 
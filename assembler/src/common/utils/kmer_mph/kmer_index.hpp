@@ -83,6 +83,10 @@ public:
     return bucket_starts_[bucket] + index_[bucket].lookup(s);
   }
 
+  void prefetch(const KMerSeq &s) const {
+    index_[seq_bucket(s)].prefetch(s);
+  }
+
   size_t raw_seq_idx(const KMerRawReference data) const {
     size_t bucket = raw_seq_bucket(data);
 
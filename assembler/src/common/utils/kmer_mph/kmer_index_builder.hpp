@@ -117,12 +117,18 @@ public:
     INFO("Splitting kmer instances into " << num_files << " files using " << num_threads << " threads. This might take a while.");
     auto raw_kmers = splitter_.Split(num_files, num_threads);
 
+    // Files i, i + num_buckets, ... hold disjoint parts of the bucket i. All
+    // their sorted runs are merged at once straight into the final bucket file
     INFO("Starting k-mer counting.");
     size_t kmers = 0;
 #   pragma omp parallel for shared(raw_kmers) num_threads(num_threads) schedule(dynamic) reduction(+:kmers)
-    for (unsigned i = 0; i < raw_kmers.size(); ++i) {
-      kmers += MergeKMers(*raw_kmers[i], GetUniqueKMersFname(i));
-      raw_kmers[i].reset();
+    for (unsigned i = 0; i < num_buckets; ++i) {
+      std::vector<std::string> ifnames;
+      for (unsigned j = 0; j < num_threads; ++j)
+        ifnames.push_back(*raw_kmers[i + j * num_buckets]);
+      kmers += MergeKMers(ifnames, GetMergedKMersFname(i));
+      for (unsigned j = 0; j < num_threads; ++j)
+        raw_kmers[i + j * num_buckets].reset();
     }
     INFO("K-mer counting done. There are " << kmers << " kmers in total. ");
     if (!kmers) {
@@ -130,16 +136,6 @@ public:
       exit(-1);
     }
 
-    INFO("Merging temporary buckets.");
-    for (unsigned i = 0; i < num_buckets; ++i) {
-      std::string ofname = GetMergedKMersFname(i);
-      std::ofstream ofs(ofname.c_str(), std::ios::out | std::ios::binary);
-      for (unsigned j = 0; j < num_threads; ++j) {
-        BucketStorage ins(GetUniqueKMersFname(i + j * num_buckets), Seq::GetDataSize(k_), /* unlink */ true);
-        ofs.write((const char*)ins.data(), ins.data_size());
-      }
-    }
-
     this->kmers_ = kmers;
     this->counted_ = true;
 
@@ -182,94 +178,82 @@ private:
   KMerSplitter<Seq> &splitter_;
   unsigned k_;
 
-  std::string GetUniqueKMersFname(unsigned suffix) const {
-    return kmer_prefix_->file() + ".unique." + std::to_string(suffix);
-  }
-
-  size_t MergeKMers(const std::string &ifname, const std::string &ofname) {
-    MMappedRecordArrayReader<typename Seq::DataType> ins(ifname, Seq::GetDataSize(k_), /* unlink */ true);
-
-    std::string IdxFileName = ifname + ".idx";
-    if (FILE *f = fopen(IdxFileName.c_str(), "rb")) {
-      fclose(f);
-      MMappedRecordReader<size_t> index(ifname + ".idx", true, -1ULL);
-
-      // INFO("Total runs: " << index.size());
-
-      // Prepare runs
-      std::vector<adt::iterator_range<decltype(ins.begin())>> ranges;
-      auto beg = ins.begin();
-      for (size_t sz : index) {
-        auto end = std::next(beg, sz);
-        ranges.push_back(adt::make_range(beg, end));
-        VERIFY(std::is_sorted(beg, end, adt::array_less<typename Seq::DataType>()));
-        beg = end;
+  size_t MergeKMers(const std::vector<std::string> &ifnames, const std::string &ofname) {
+    typedef MMappedRecordArrayReader<typename Seq::DataType> RawKMerReader;
+    std::vector<std::unique_ptr<RawKMerReader>> ins;
+    std::vector<adt::iterator_range<typename RawKMerReader::iterator>> ranges;
+
+    // Prepare runs. Splitter output consists of sorted runs listed in the
+    // index file, inputs without one are sorted as a whole in place.
+    for (const std::string &ifname : ifnames) {
+      ins.emplace_back(new RawKMerReader(ifname, Seq::GetDataSize(k_), /* unlink */ true));
+      RawKMerReader &in = *ins.back();
+
+      std::string IdxFileName = ifname + ".idx";
+      if (FILE *f = fopen(IdxFileName.c_str(), "rb")) {
+        fclose(f);
+        MMappedRecordReader<size_t> index(IdxFileName, true, -1ULL);
+
+        auto beg = in.begin();
+        for (size_t sz : index) {
+          auto end = std::next(beg, sz);
+          ranges.push_back(adt::make_range(beg, end));
+          VERIFY(std::is_sorted(beg, end, adt::array_less<typename Seq::DataType>()));
+          beg = end;
+        }
+      } else {
+        libcxx::sort(in.begin(), in.end(), adt::array_less<typename Seq::DataType>());
+        ranges.push_back(adt::make_range(in.begin(), in.end()));
       }
+    }
 
-      // Construct tree on top entries of runs
-      adt::loser_tree<decltype(beg),
-              adt::array_less<typename Seq::DataType>> tree(ranges);
+    FILE *g = fopen(ofname.c_str(), "wb");
+    if (!g)
+      FATAL_ERROR("Cannot open temporary file " << ofname << " for writing");
 
-      if (tree.empty()) {
-        FILE *g = fopen(ofname.c_str(), "ab");
-        if (!g)
-          FATAL_ERROR("Cannot open temporary file " << ofname << " for writing");
-        fclose(g);
-        return 0;
-      }
+    if (ranges.empty()) {
+      fclose(g);
+      return 0;
+    }
 
-      // Write it down!
-      adt::KMerVector<Seq> buf(k_, 1024*1024);
-      auto pval = tree.pop();
-      size_t total = 0;
-      while (!tree.empty()) {
-          buf.clear();
-          for (size_t cnt = 0; cnt < buf.capacity() && !tree.empty(); ) {
-              auto cval = tree.pop();
-              if (!adt::array_equal_to<typename Seq::DataType>()(pval, cval)) {
-                  buf.push_back(pval);
-                  pval = cval;
-                  cnt += 1;
-              }
-          }
-          total += buf.size();
-
-          FILE *g = fopen(ofname.c_str(), "ab");
-          if (!g)
-            FATAL_ERROR("Cannot open temporary file " << ofname << " for writing");
-          size_t res = fwrite(buf.data(), buf.el_data_size(), buf.size(), g);
-          if (res != buf.size())
-            FATAL_ERROR("I/O error! Incomplete write! Reason: " << strerror(errno) << ". Error code: " << errno);
-          fclose(g);
-      }
+    // Construct tree on top entries of runs
+    adt::loser_tree<typename RawKMerReader::iterator,
+                    adt::array_less<typename Seq::DataType>> tree(ranges);
 
-      // Handle very last value
-      {
-        FILE *g = fopen(ofname.c_str(), "ab");
-        if (!g)
-          FATAL_ERROR("Cannot open temporary file " << ofname << " for writing");
-        size_t res = fwrite(pval.data(), pval.data_size(), 1, g);
-        if (res != 1)
-          FATAL_ERROR("I/O error! Incomplete write! Reason: " << strerror(errno) << ". Error code: " << errno);
-        fclose(g);
-        total += 1;
-      }
+    if (tree.empty()) {
+      fclose(g);
+      return 0;
+    }
 
-      return total;
-    } else {
-      // Sort the stuff
-      libcxx::sort(ins.begin(), ins.end(), adt::array_less<typename Seq::DataType>());
+    // Write it down, dropping the duplicates on the fly
+    adt::KMerVector<Seq> buf(k_, 1024*1024);
+    auto pval = tree.pop();
+    size_t total = 0;
+    while (!tree.empty()) {
+      buf.clear();
+      for (size_t cnt = 0; cnt < buf.capacity() && !tree.empty(); ) {
+        auto cval = tree.pop();
+        if (!adt::array_equal_to<typename Seq::DataType>()(pval, cval)) {
+          buf.push_back(pval);
+          pval = cval;
+          cnt += 1;
+        }
+      }
+      total += buf.size();
 
-      // FIXME: Use something like parallel version of unique_copy but with explicit
-      // resizing.
-      auto it = std::unique(ins.begin(), ins.end(), adt::array_equal_to<typename Seq::DataType>());
+      size_t res = fwrite(buf.data(), buf.el_data_size(), buf.size(), g);
+      if (res != buf.size())
+        FATAL_ERROR("I/O error! Incomplete write! Reason: " << strerror(errno) << ". Error code: " << errno);
+    }
 
-      MMappedRecordArrayWriter<typename Seq::DataType> os(ofname, Seq::GetDataSize(k_));
-      os.resize(it - ins.begin());
-      std::copy(ins.begin(), it, os.begin());
+    // Handle very last value
+    size_t res = fwrite(pval.data(), pval.data_size(), 1, g);
+    if (res != 1)
+      FATAL_ERROR("I/O error! Incomplete write! Reason: " << strerror(errno) << ". Error code: " << errno);
+    total += 1;
+    fclose(g);
 
-      return it - ins.begin();
-    }
+    return total;
   }
 };
 
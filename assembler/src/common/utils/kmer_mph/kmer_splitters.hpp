@@ -184,12 +184,13 @@ class DeBruijnKMerSplitter : public RtSeqKMerSplitter {
  protected:
   size_t read_buffer_size_;
  protected:
-  bool FillBufferFromSequence(const Sequence &seq,
+  template<class Seq>
+  bool FillBufferFromSequence(const Seq &seq,
                               unsigned thread_id) {
       if (seq.size() < this->K_)
         return false;
 
-      RtSeq kmer = seq.start<RtSeq>(this->K_) >> 'A';
+      RtSeq kmer = seq.template start<RtSeq>(this->K_) >> 'A';
       bool stop = false;
       for (size_t j = this->K_ - 1; j < seq.size(); ++j) {
         kmer <<= seq[j];
@@ -47,6 +47,12 @@ public:
         return idx_;
     }
 
+    //Only a hint, brings the hash function data needed by idx() into cache
+    void prefetch() const {
+        if (!ready_)
+            hash_.prefetch(key_);
+    }
+
     SimpleKeyWithHash &operator=(const SimpleKeyWithHash &that) {
         VERIFY(&this->hash_ == &that.hash_);
         this->key_= that.key_;
@@ -144,6 +150,13 @@ private:
         return idx_;
     }
 
+    //Only a hint, brings the hash function data needed by idx() into cache.
+    //Note that non-minimal keys are hashed via their reverse complement
+    void prefetch() const {
+        if (!ready_)
+            hash_.prefetch(key_.IsMinimal() ? key_ : !key_);
+    }
+
     bool is_minimal() const {
         if(!ready_) {
             return key_.IsMinimal();
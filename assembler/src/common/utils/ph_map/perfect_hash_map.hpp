@@ -113,6 +113,19 @@ public:
         return StoringType::get_value(*this, kwh);
     }
 
+    //Lookup hints. The first one prefetches the hash function data of the key,
+    //the second one (issued when that data is expected to be in cache) computes
+    //the index and prefetches the value slot. The index is cached in kwh.
+    void prefetch(const KeyWithHash &kwh) const {
+        kwh.prefetch();
+    }
+
+    void prefetch_value(const KeyWithHash &kwh) const {
+        size_t idx = kwh.idx();
+        if (KeyBase::valid(idx))
+            __builtin_prefetch(&ValueBase::operator[](idx));
+    }
+
     template<typename F>
     const V get_value(const KeyWithHash &kwh, const F& inverter) const {
         return StoringType::get_value(*this, kwh, inverter);
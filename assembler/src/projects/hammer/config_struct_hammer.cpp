@@ -69,6 +69,7 @@ void load(hammer_config& cfg, boost::property_tree::ptree const& pt) {
   load(cfg.correct_readbuffer, pt, "correct_readbuffer");
   load(cfg.correct_discard_bad, pt, "correct_discard_bad");
   load(cfg.correct_stats, pt, "correct_stats");
+  cfg.correct_gzip_output = pt.get("correct_gzip_output", false);
 
   std::string fname;
   load(fname, pt, "dataset");
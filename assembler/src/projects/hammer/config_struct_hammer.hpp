@@ -76,7 +76,8 @@ struct hammer_config {
   double correct_threshold;
   unsigned correct_readbuffer;
   unsigned correct_nthreads;
-  bool correct_stats;  
+  bool correct_stats;
+  bool correct_gzip_output;
 };
 
 
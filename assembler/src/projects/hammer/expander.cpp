@@ -17,11 +17,49 @@
 #include <vector>
 #include <cstring>
 
-bool Expander::operator()(std::unique_ptr<Read> r) {
+FrontierWriter::FrontierWriter(const std::string &fname)
+    : ofs_(fname, std::ios::binary), size_(0) {
+  VERIFY_MSG(ofs_.good(), "Failed to open " << fname);
+}
+
+void FrontierWriter::Add(const Read &r) {
+  const std::string &seq = r.getSequenceString(), &qual = r.getQualityString();
+  uint32_t sz = (uint32_t)seq.size();
+
+# pragma omp critical(expander_frontier)
+  {
+    ofs_.write((const char*)&sz, sizeof(sz));
+    ofs_.write(seq.data(), sz);
+    ofs_.write(qual.data(), sz);
+    size_ += 1;
+  }
+}
+
+FrontierReader::FrontierReader(const std::string &fname)
+    : ifs_(fname, std::ios::binary), next_size_(0), eof_(false) {
+  VERIFY_MSG(ifs_.good(), "Failed to open " << fname);
+  ReadAhead();
+}
+
+void FrontierReader::ReadAhead() {
+  eof_ = !ifs_.read((char*)&next_size_, sizeof(next_size_));
+}
+
+FrontierReader &FrontierReader::operator>>(Read &r) {
+  std::string seq(next_size_, '\0'), qual(next_size_, '\0');
+  ifs_.read(&seq[0], next_size_);
+  ifs_.read(&qual[0], next_size_);
+  VERIFY_MSG(ifs_.good(), "Truncated expansion frontier");
+  r = Read("", seq, qual);
+  ReadAhead();
+  return *this;
+}
+
+bool Expander::operator()(const Read &r) {
   uint8_t trim_quality = (uint8_t)cfg::get().input_trim_quality;
 
   // FIXME: Get rid of this
-  Read cr = *r;
+  Read cr = r;
   size_t sz = cr.trimNsAndBadQuality(trim_quality);
 
   if (sz < hammer::K)
@@ -29,6 +67,7 @@ bool Expander::operator()(std::unique_ptr<Read> r) {
 
   std::vector<unsigned> covered_by_solid(sz, false);
   std::vector<size_t> kmer_indices(sz, -1ull);
+  bool has_weak = false;
 
   ValidKMerGenerator<hammer::K> gen(cr);
   while (gen.HasMore()) {
@@ -41,14 +80,22 @@ bool Expander::operator()(std::unique_ptr<Read> r) {
       if (data_[idx].good()) {
         for (size_t j = read_pos; j < read_pos + hammer::K; ++j)
           covered_by_solid[j] = true;
-      }
+      } else
+        has_weak = true;
     }
     gen.Next();
   }
 
+  // Solid k-mers stay solid, so a read without weak ones will never change anything
+  if (!has_weak)
+    return false;
+
   for (size_t j = 0; j < sz; ++j)
-    if (!covered_by_solid[j])
+    if (!covered_by_solid[j]) {
+      if (frontier_)
+        frontier_->Add(cr);
       return false;
+    }
 
   for (size_t j = 0; j < sz; ++j) {
     if (kmer_indices[j] == -1ull)
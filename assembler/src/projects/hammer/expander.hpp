@@ -12,19 +12,55 @@ class KMerData;
 class Read;
 
 #include <cstring>
+#include <fstream>
 #include <memory>
+#include <string>
+
+/// Reads which may still produce new solid k-mers, kept between the expansion
+/// iterations: trimmed sequence and quality, no names.
+class FrontierWriter {
+  std::ofstream ofs_;
+  size_t size_;
+
+ public:
+  explicit FrontierWriter(const std::string &fname);
+
+  /// thread-safe
+  void Add(const Read &r);
+
+  size_t size() const { return size_; }
+};
+
+class FrontierReader {
+  std::ifstream ifs_;
+  uint32_t next_size_;
+  bool eof_;
+
+  void ReadAhead();
+
+ public:
+  typedef Read ReadT;
+
+  explicit FrontierReader(const std::string &fname);
+
+  bool eof() const { return eof_; }
+
+  FrontierReader &operator>>(Read &r);
+};
 
 class Expander {
   KMerData &data_;
   size_t changed_;
+  FrontierWriter *frontier_;
   
  public:
-  Expander(KMerData &data) 
-      : data_(data), changed_(0) {}
+  /// reads having non-solid k-mers after the expansion are passed to frontier, if any
+  Expander(KMerData &data, FrontierWriter *frontier = nullptr)
+      : data_(data), changed_(0), frontier_(frontier) {}
 
   size_t changed() const { return changed_; }
 
-  bool operator()(std::unique_ptr<Read> r);
+  bool operator()(const Read &r);
 };
 
 #endif
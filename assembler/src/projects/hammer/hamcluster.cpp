@@ -14,6 +14,9 @@
 #include "config_struct_hammer.hpp"
 #include "globals.hpp"
 
+#include "utils/memory_limit.hpp"
+#include "utils/parallel/openmp_wrapper.h"
+
 #include <iostream>
 #include <sstream>
 
@@ -108,9 +111,109 @@ static void processBlockQuadratic(dsu::ConcurrentDSU  &uf,
   }
 }
 
+// Sub-k-mers and k-mer indices of a partition, their radix sort buffers and the
+// indices of big blocks of all the partitions
+static size_t InMemoryClusteringMemory(size_t kmers, unsigned tau) {
+  return kmers * (2 * (sizeof(SubKMer) + sizeof(size_t)) + (tau + 1) * sizeof(size_t));
+}
+
+// Returns the starts of the runs of equal sub-k-mers, followed by the total size
+static std::vector<size_t> BlockStarts(const std::vector<SubKMer> &subkmers) {
+  std::vector<size_t> starts;
+  for (size_t i = 0; i < subkmers.size(); ++i) {
+    if (i == 0 || subkmers[i] != subkmers[i - 1])
+      starts.push_back(i);
+  }
+  starts.push_back(subkmers.size());
+  return starts;
+}
+
+void KMerHamClusterer::clusterInMemory(const KMerData &data,
+                                       dsu::ConcurrentDSU &uf) {
+  unsigned nthreads = cfg::get().general_max_nthreads;
+  unsigned block_thr = cfg::get().hamming_blocksize_quadratic_threshold;
+  size_t n = data.size();
+
+  std::vector<SubKMer> subkmers(n);
+  std::vector<size_t> indices(n);
+  // Blocks to be split once more by strided sub-k-mers, as k-mer indices
+  std::vector<std::vector<size_t>> big_blocks;
+  size_t nblocks = 0;
+  for (unsigned part = 0; part < tau_ + 1; ++part) {
+    SubKMerPartSerializer serializer((*Globals::subKMerPositions)[part],
+                                     (*Globals::subKMerPositions)[part + 1]);
+#   pragma omp parallel for num_threads(nthreads)
+    for (size_t i = 0; i < n; ++i) {
+      subkmers[i] = serializer.serialize(data.kmer(i));
+      indices[i] = i;
+    }
+
+    using PairSort = parallel_radix_sort::PairSort<SubKMer, size_t, SubKMer, EncoderKMer>;
+    PairSort::InitAndSort(subkmers.data(), indices.data(), n, nthreads);
+
+    std::vector<size_t> starts = BlockStarts(subkmers);
+    nblocks += starts.size() - 1;
+#   pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (size_t b = 0; b < starts.size() - 1; ++b) {
+      auto block = indices.begin() + starts[b];
+      size_t sz = starts[b + 1] - starts[b];
+      if (sz < block_thr) {
+        processBlockQuadratic(uf, block, sz, data, tau_);
+      } else {
+#       pragma omp critical
+        big_blocks.emplace_back(block, block + sz);
+      }
+    }
+  }
+  INFO("Splitting done, pass 1. Produced " << nblocks << " blocks, "
+       << big_blocks.size() << " of them are big.");
+
+  // Largest blocks first to balance the threads
+  std::sort(big_blocks.begin(), big_blocks.end(),
+            [](const std::vector<size_t> &a, const std::vector<size_t> &b) { return a.size() > b.size(); });
+  size_t ntasks = big_blocks.size() * (tau_ + 1);
+  size_t big_blocks2 = 0;
+# pragma omp parallel for schedule(dynamic) num_threads(nthreads) reduction(+:big_blocks2)
+  for (size_t task = 0; task < ntasks; ++task) {
+    const auto &block = big_blocks[task / (tau_ + 1)];
+    SubKMerStridedSerializer serializer(task % (tau_ + 1), tau_ + 1);
+
+    std::vector<std::pair<SubKMer, size_t>> entries;
+    entries.reserve(block.size());
+    for (size_t idx : block)
+      entries.emplace_back(serializer.serialize(data.kmer(idx)), idx);
+    std::sort(entries.begin(), entries.end(),
+              [](const std::pair<SubKMer, size_t> &a, const std::pair<SubKMer, size_t> &b) {
+                return SubKMerComparator()(a.first, b.first);
+              });
+
+    std::vector<size_t> sorted(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+      sorted[i] = entries[i].second;
+
+    for (size_t start = 0; start < entries.size();) {
+      size_t end = start + 1;
+      while (end < entries.size() && entries[end].first == entries[start].first)
+        end += 1;
+      if (end - start > 50)
+        big_blocks2 += 1;
+      processBlockQuadratic(uf, sorted.begin() + start, end - start, data, tau_);
+      start = end;
+    }
+  }
+  INFO("Splitting done, pass 2. Saw " << big_blocks2 << " big blocks.");
+}
+
 void KMerHamClusterer::cluster(const std::string &prefix,
                                const KMerData &data,
                                dsu::ConcurrentDSU &uf) {
+  size_t memory = InMemoryClusteringMemory(data.size(), tau_);
+  if (memory < utils::get_free_memory() / 2) {
+    INFO("Clustering in memory, " << memory / (1 << 20) << " MB needed.");
+    clusterInMemory(data, uf);
+    return;
+  }
+
   // First pass - split & sort the k-mers
   std::string fname = prefix + ".first", bfname = fname + ".blocks", kfname = fname + ".kmers";
   std::ofstream bfs(bfname, std::ios::out | std::ios::binary);
@@ -146,6 +146,9 @@ class KMerHamClusterer {
 
   void cluster(const std::string &prefix, const KMerData &data, dsu::ConcurrentDSU &uf);
  private:
+  // Same as cluster(), but sub-k-mers are sorted in memory and blocks are processed in parallel
+  void clusterInMemory(const KMerData &data, dsu::ConcurrentDSU &uf);
+
   DECL_LOGGER("Hamming Clustering");
 };
 
@@ -16,9 +16,18 @@
 #include "io/kmers/mmapped_writer.hpp"
 #include "utils/filesystem/path_helper.hpp"
 
+#include <zlib.h>
+
+#include <condition_variable>
+#include <deque>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 #include "config_struct_hammer.hpp"
 
@@ -76,120 +85,295 @@ string getFilename( const string & dirprefix, int iter_count, const string & suf
   return tmp.str();
 }
 
-CorrectionStats CorrectReadsBatch(std::vector<bool> &res,
-                       std::vector<Read> &reads, size_t buf_size,
-                       const KMerData &data) {
-  unsigned correct_nthreads = min(cfg::get().correct_nthreads, cfg::get().general_max_nthreads);
-  bool discard_singletons = cfg::get().bayes_discard_only_singletons;
-  bool correct_threshold = cfg::get().correct_use_threshold;
-  bool discard_bad = cfg::get().correct_discard_bad;
-
-  ReadCorrector corrector(data, cfg::get().correct_stats);
-# pragma omp parallel for shared(reads, res, data) num_threads(correct_nthreads)
-  for (size_t i = 0; i < buf_size; ++i) {
-    if (reads[i].size() >= K) {
-      res[i] =
-          corrector.CorrectOneRead(reads[i],
-                                   correct_threshold, discard_singletons, discard_bad);
-    } else
-      res[i] = false;
+CorrectedReadsFile::CorrectedReadsFile(const std::string &fname, bool gzip)
+    : ofs_(fname, std::ios::out | std::ios::binary), gzip_(gzip), empty_(true) {
+  VERIFY_MSG(ofs_.good(), "Failed to open " << fname);
+}
+
+CorrectedReadsFile::~CorrectedReadsFile() {
+  // An empty file is not a valid gzip one
+  if (gzip_ && empty_)
+    Write(Pack(""));
+}
+
+std::string CorrectedReadsFile::Pack(std::string chunk) const {
+  if (!gzip_)
+    return chunk;
+
+  // Every chunk becomes a separate gzip member, their concatenation is a valid gzip file
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  int res = deflateInit2(&zs, GZIP_LEVEL, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+  VERIFY_MSG(res == Z_OK, "Failed to initialize deflate: " << res);
+  std::string packed(deflateBound(&zs, uLong(chunk.size())), '\0');
+  zs.next_in = (Bytef*) chunk.data();
+  zs.avail_in = uInt(chunk.size());
+  zs.next_out = (Bytef*) &packed[0];
+  zs.avail_out = uInt(packed.size());
+  res = deflate(&zs, Z_FINISH);
+  VERIFY_MSG(res == Z_STREAM_END, "Failed to compress corrected reads: " << res);
+  packed.resize(zs.total_out);
+  deflateEnd(&zs);
+  return packed;
+}
+
+void CorrectedReadsFile::Write(const std::string &chunk) {
+  ofs_.write(chunk.data(), chunk.size());
+  VERIFY_MSG(!ofs_.fail(), "Failed to write corrected reads");
+  empty_ &= chunk.empty();
+}
+
+namespace {
+
+/*
+ * Runs batches through read -> process -> write stages: one reader thread, nworkers
+ * processing threads and the writer in the calling thread. Batches are written in the
+ * order they were read, at most max_batches of them are in flight at once.
+ * read(batch) returns false when the input is exhausted, process(batch, worker) is
+ * called concurrently for different batches.
+ */
+template<class Batch, class Reader, class Processor, class Writer>
+void RunOrderedPipeline(unsigned nworkers, size_t max_batches,
+                        Reader &&read, Processor &&process, Writer &&write) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<std::unique_ptr<Batch>> free_batches;
+  std::deque<std::pair<size_t, std::unique_ptr<Batch>>> todo;
+  std::map<size_t, std::unique_ptr<Batch>> done;
+  size_t in_flight = 0, nread = 0;
+  bool input_end = false;
+
+  std::thread reader([&] {
+    for (;;) {
+      std::unique_ptr<Batch> batch;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return in_flight < max_batches; });
+        in_flight += 1;
+        if (free_batches.empty()) {
+          batch.reset(new Batch());
+        } else {
+          batch = std::move(free_batches.back());
+          free_batches.pop_back();
+        }
+      }
+
+      bool success = read(*batch);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!success) {
+        in_flight -= 1;
+        input_end = true;
+        cv.notify_all();
+        return;
+      }
+      todo.emplace_back(nread++, std::move(batch));
+      cv.notify_all();
+    }
+  });
+
+  std::vector<std::thread> workers;
+  for (unsigned i = 0; i < nworkers; ++i) {
+    workers.emplace_back([&, i] {
+      for (;;) {
+        std::pair<size_t, std::unique_ptr<Batch>> item;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          cv.wait(lock, [&] { return !todo.empty() || input_end; });
+          if (todo.empty())
+            return;
+          item = std::move(todo.front());
+          todo.pop_front();
+        }
+
+        process(*item.second, i);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        done.emplace(item.first, std::move(item.second));
+        cv.notify_all();
+      }
+    });
   }
 
-  CorrectionStats stats;
+  for (size_t next = 0; ; ++next) {
+    std::unique_ptr<Batch> batch;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&] { return done.count(next) || (input_end && next == nread); });
+      auto it = done.find(next);
+      if (it == done.end())
+        break;
+      batch = std::move(it->second);
+      done.erase(it);
+    }
+
+    write(*batch);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    in_flight -= 1;
+    free_batches.push_back(std::move(batch));
+    cv.notify_all();
+  }
+
+  reader.join();
+  for (auto &worker : workers)
+    worker.join();
+}
+
+struct CorrectionBatch {
+  // Left and right mates, only the left ones for single reads
+  std::vector<Read> reads[2];
+  std::vector<bool> res[2];
+  size_t size = 0;
+  // Formatted (and packed) reads, one chunk per output file
+  std::vector<std::string> chunks;
+};
+
+class BatchCorrector {
+  int qvoffset_;
+  bool correct_threshold_, discard_singletons_, discard_bad_;
+  std::vector<ReadCorrector> correctors_;
+
+ public:
+  BatchCorrector(const KMerData &data, unsigned nworkers)
+      : qvoffset_(cfg::get().input_qvoffset),
+        correct_threshold_(cfg::get().correct_use_threshold),
+        discard_singletons_(cfg::get().bayes_discard_only_singletons),
+        discard_bad_(cfg::get().correct_discard_bad) {
+    // Every worker has its own corrector, so that the statistics are not shared
+    for (unsigned i = 0; i < nworkers; ++i)
+      correctors_.emplace_back(data, cfg::get().correct_stats);
+  }
+
+  void Correct(CorrectionBatch &batch, size_t mate, unsigned worker) {
+    ReadCorrector &corrector = correctors_[worker];
+    for (size_t i = 0; i < batch.size; ++i) {
+      Read &read = batch.reads[mate][i];
+      batch.res[mate][i] = read.size() >= K &&
+                           corrector.CorrectOneRead(read, correct_threshold_, discard_singletons_, discard_bad_);
+    }
+  }
+
+  // Formats the reads, out(i) gives the output file index for the i-th read (pair)
+  template<class Output>
+  void Format(CorrectionBatch &batch, const std::vector<CorrectedReadsFile*> &files, Output &&out) const {
+    std::vector<std::ostringstream> streams(files.size());
+    for (size_t i = 0; i < batch.size; ++i)
+      out(i, streams);
+
+    batch.chunks.resize(files.size());
+    for (size_t j = 0; j < files.size(); ++j)
+      batch.chunks[j] = files[j]->Pack(streams[j].str());
+  }
+
+  int qvoffset() const {
+    return qvoffset_;
+  }
+
+  CorrectionStats stats() const {
+    CorrectionStats stats;
+    for (const auto &corrector : correctors_) {
+      stats.changedReads += corrector.changed_reads();
+      stats.changedNucleotides += corrector.changed_nucleotides();
+      stats.uncorrectedNucleotides += corrector.uncorrected_nucleotides();
+      stats.totalNucleotides += corrector.total_nucleotides();
+    }
+    return stats;
+  }
+};
+
+void WriteChunks(const CorrectionBatch &batch, const std::vector<CorrectedReadsFile*> &files) {
+  for (size_t j = 0; j < files.size(); ++j)
+    files[j]->Write(batch.chunks[j]);
+}
 
-  stats.changedReads += corrector.changed_reads();
-  stats.changedNucleotides += corrector.changed_nucleotides();
-  stats.uncorrectedNucleotides += corrector.uncorrected_nucleotides();
-  stats.totalNucleotides += corrector.total_nucleotides();
-  return stats;
 }
 
 CorrectionStats CorrectReadFile(const KMerData &data,
                      const std::string &fname,
-                     std::ofstream *outf_good, std::ofstream *outf_bad) {
+                     CorrectedReadsFile &outf_good, CorrectedReadsFile &outf_bad) {
   int qvoffset = cfg::get().input_qvoffset;
   int trim_quality = cfg::get().input_trim_quality;
-
   unsigned correct_nthreads = min(cfg::get().correct_nthreads, cfg::get().general_max_nthreads);
-  size_t read_buffer_size = correct_nthreads * cfg::get().correct_readbuffer;
-  std::vector<Read> reads(read_buffer_size);
-  std::vector<bool> res(read_buffer_size, false);
+  size_t batch_size = cfg::get().correct_readbuffer;
 
   ireadstream irs(fname, qvoffset);
   VERIFY(irs.is_open());
 
-  unsigned buffer_no = 0;
-  CorrectionStats stats;
-  while (!irs.eof()) {
-    size_t buf_size = 0;
-    for (; buf_size < read_buffer_size && !irs.eof(); ++buf_size) {
-      irs >> reads[buf_size];
-      reads[buf_size].trimNsAndBadQuality(trim_quality);
-    }
-    INFO("Prepared batch " << buffer_no << " of " << buf_size << " reads.");
-
-    stats += CorrectReadsBatch(res, reads, buf_size,
-                               data);
-
-    INFO("Processed batch " << buffer_no);
-    for (size_t i = 0; i < buf_size; ++i) {
-      reads[i].print(*(res[i] ? outf_good : outf_bad), qvoffset);
-    }
-    INFO("Written batch " << buffer_no);
-    ++buffer_no;
-  }
-  return stats;
+  BatchCorrector corrector(data, correct_nthreads);
+  std::vector<CorrectedReadsFile*> files = { &outf_good, &outf_bad };
+  RunOrderedPipeline<CorrectionBatch>(
+      correct_nthreads, correct_nthreads + 2,
+      [&](CorrectionBatch &batch) {
+        batch.reads[0].resize(batch_size);
+        batch.res[0].resize(batch_size);
+        for (batch.size = 0; batch.size < batch_size && !irs.eof(); ++batch.size) {
+          irs >> batch.reads[0][batch.size];
+          batch.reads[0][batch.size].trimNsAndBadQuality(trim_quality);
+        }
+        return batch.size > 0;
+      },
+      [&](CorrectionBatch &batch, unsigned worker) {
+        corrector.Correct(batch, 0, worker);
+        corrector.Format(batch, files, [&](size_t i, std::vector<std::ostringstream> &out) {
+          batch.reads[0][i].print(out[batch.res[0][i] ? 0 : 1], qvoffset);
+        });
+      },
+      [&](const CorrectionBatch &batch) { WriteChunks(batch, files); });
+
+  return corrector.stats();
 }
 
 CorrectionStats CorrectPairedReadFiles(const KMerData &data,
                             const std::string &fnamel, const std::string &fnamer,
-                            ofstream * ofbadl, ofstream * ofcorl, ofstream * ofbadr, ofstream * ofcorr, ofstream * ofunp) {
+                            CorrectedReadsFile &ofbadl, CorrectedReadsFile &ofcorl,
+                            CorrectedReadsFile &ofbadr, CorrectedReadsFile &ofcorr,
+                            CorrectedReadsFile &ofunp) {
   int qvoffset = cfg::get().input_qvoffset;
   int trim_quality = cfg::get().input_trim_quality;
-
   unsigned correct_nthreads = min(cfg::get().correct_nthreads, cfg::get().general_max_nthreads);
-  size_t read_buffer_size = correct_nthreads * cfg::get().correct_readbuffer;
-  std::vector<Read> l(read_buffer_size);
-  std::vector<Read> r(read_buffer_size);
-  std::vector<bool> left_res(read_buffer_size, false);
-  std::vector<bool> right_res(read_buffer_size, false);
-
-  unsigned buffer_no = 0;
+  size_t batch_size = cfg::get().correct_readbuffer;
 
   ireadstream irsl(fnamel, qvoffset), irsr(fnamer, qvoffset);
   VERIFY(irsl.is_open()); VERIFY(irsr.is_open());
-  CorrectionStats stats;
 
-  while (!irsl.eof() && !irsr.eof()) {
-    size_t buf_size = 0;
-    for (; buf_size < read_buffer_size && !irsl.eof() && !irsr.eof(); ++buf_size) {
-      irsl >> l[buf_size]; irsr >> r[buf_size];
-      l[buf_size].trimNsAndBadQuality(trim_quality);
-      r[buf_size].trimNsAndBadQuality(trim_quality);
-    }
-    INFO("Prepared batch " << buffer_no << " of " << buf_size << " reads.");
-
-    stats += CorrectReadsBatch(left_res, l, buf_size,
-                      data);
-    stats += CorrectReadsBatch(right_res, r, buf_size,
-                      data);
-
-    INFO("Processed batch " << buffer_no);
-    for (size_t i = 0; i < buf_size; ++i) {
-      if (left_res[i] && right_res[i]) {
-        l[i].print(*ofcorl, qvoffset);
-        r[i].print(*ofcorr, qvoffset);
-      } else {
-        l[i].print(*(left_res[i] ? ofunp : ofbadl), qvoffset);
-        r[i].print(*(right_res[i] ? ofunp : ofbadr), qvoffset);
-      }
-    }
-    INFO("Written batch " << buffer_no);
-    ++buffer_no;
-  }
+  enum { CORL, CORR, BADL, BADR, UNP };
+  BatchCorrector corrector(data, correct_nthreads);
+  std::vector<CorrectedReadsFile*> files = { &ofcorl, &ofcorr, &ofbadl, &ofbadr, &ofunp };
+  RunOrderedPipeline<CorrectionBatch>(
+      correct_nthreads, correct_nthreads + 2,
+      [&](CorrectionBatch &batch) {
+        for (size_t mate = 0; mate < 2; ++mate) {
+          batch.reads[mate].resize(batch_size);
+          batch.res[mate].resize(batch_size);
+        }
+        for (batch.size = 0; batch.size < batch_size && !irsl.eof() && !irsr.eof(); ++batch.size) {
+          irsl >> batch.reads[0][batch.size]; irsr >> batch.reads[1][batch.size];
+          batch.reads[0][batch.size].trimNsAndBadQuality(trim_quality);
+          batch.reads[1][batch.size].trimNsAndBadQuality(trim_quality);
+        }
+        return batch.size > 0;
+      },
+      [&](CorrectionBatch &batch, unsigned worker) {
+        corrector.Correct(batch, 0, worker);
+        corrector.Correct(batch, 1, worker);
+        corrector.Format(batch, files, [&](size_t i, std::vector<std::ostringstream> &out) {
+          const Read &l = batch.reads[0][i], &r = batch.reads[1][i];
+          bool left_res = batch.res[0][i], right_res = batch.res[1][i];
+          if (left_res && right_res) {
+            l.print(out[CORL], qvoffset);
+            r.print(out[CORR], qvoffset);
+          } else {
+            l.print(out[left_res ? UNP : BADL], qvoffset);
+            r.print(out[right_res ? UNP : BADR], qvoffset);
+          }
+        });
+      },
+      [&](const CorrectionBatch &batch) { WriteChunks(batch, files); });
+
   if (!irsl.eof() || !irsr.eof())
       FATAL_ERROR("Pair of read files " + fnamel + " and " + fnamer + " contain unequal amount of reads");
-  return stats;
+  return corrector.stats();
 }
 
 std::string getLargestPrefix(const std::string &str1, const std::string &str2) {
@@ -204,14 +388,14 @@ std::string getLargestPrefix(const std::string &str1, const std::string &str2) {
 }
 
 std::string CorrectSingleReadSet(size_t ilib, size_t iread, const std::string &fn, CorrectionStats &stats) {
+  bool gzip = cfg::get().correct_gzip_output;
   std::string usuffix = std::to_string(ilib) + "_" +
-                        std::to_string(iread) + ".cor.fastq";
+                        std::to_string(iread) + (gzip ? ".cor.fastq.gz" : ".cor.fastq");
 
   std::string outcor = getReadsFilename(cfg::get().output_dir, fn, Globals::iteration_no, usuffix);
-  std::ofstream ofgood(outcor.c_str());
-  std::ofstream ofbad(getReadsFilename(cfg::get().output_dir, fn, Globals::iteration_no, "bad.fastq").c_str(),
-                      std::ios::out | std::ios::ate);
-  stats += CorrectReadFile(*Globals::kmer_data, fn, &ofgood, &ofbad);
+  CorrectedReadsFile ofgood(outcor, gzip);
+  CorrectedReadsFile ofbad(getReadsFilename(cfg::get().output_dir, fn, Globals::iteration_no, "bad.fastq"), false);
+  stats += CorrectReadFile(*Globals::kmer_data, fn, ofgood, ofbad);
   return outcor;
 }
 
@@ -233,8 +417,9 @@ size_t CorrectAllReads() {
     size_t iread = 0;
     for (auto I = lib.paired_begin(), E = lib.paired_end(); I != E; ++I, ++iread) {
       INFO("Correcting pair of reads: " << I->first << " and " << I->second);
+      bool gzip = cfg::get().correct_gzip_output;
       std::string usuffix =  std::to_string(ilib) + "_" +
-                             std::to_string(iread) + ".cor.fastq";
+                             std::to_string(iread) + (gzip ? ".cor.fastq.gz" : ".cor.fastq");
 
       std::string unpaired = getLargestPrefix(I->first, I->second) + "_unpaired.fastq";
 
@@ -242,17 +427,15 @@ size_t CorrectAllReads() {
       std::string outcorr = getReadsFilename(cfg::get().output_dir, I->second, Globals::iteration_no, usuffix);
       std::string outcoru = getReadsFilename(cfg::get().output_dir, unpaired,  Globals::iteration_no, usuffix);
 
-      std::ofstream ofcorl(outcorl.c_str());
-      std::ofstream ofbadl(getReadsFilename(cfg::get().output_dir, I->first,  Globals::iteration_no, "bad.fastq").c_str(),
-                           std::ios::out | std::ios::ate);
-      std::ofstream ofcorr(outcorr.c_str());
-      std::ofstream ofbadr(getReadsFilename(cfg::get().output_dir, I->second, Globals::iteration_no, "bad.fastq").c_str(),
-                           std::ios::out | std::ios::ate);
-      std::ofstream ofunp (outcoru.c_str());
+      CorrectedReadsFile ofcorl(outcorl, gzip);
+      CorrectedReadsFile ofbadl(getReadsFilename(cfg::get().output_dir, I->first,  Globals::iteration_no, "bad.fastq"), false);
+      CorrectedReadsFile ofcorr(outcorr, gzip);
+      CorrectedReadsFile ofbadr(getReadsFilename(cfg::get().output_dir, I->second, Globals::iteration_no, "bad.fastq"), false);
+      CorrectedReadsFile ofunp(outcoru, gzip);
 
       stats += CorrectPairedReadFiles(*Globals::kmer_data,
                              I->first, I->second,
-                             &ofbadl, &ofcorl, &ofbadr, &ofcorr, &ofunp);
+                             ofbadl, ofcorl, ofbadr, ofcorr, ofunp);
       outlib.push_back_paired(outcorl, outcorr);
       outlib.push_back_single(outcoru);
     }
@@ -44,22 +44,35 @@ struct CorrectionStats {
   }
 };
 
-/// parallel correction of batch of reads
-CorrectionStats CorrectReadsBatch(std::vector<bool> &res, std::vector<Read> &reads, size_t buf_size,
-                       size_t &changedReads, size_t &changedNucleotides, size_t &uncorrectedNucleotides, size_t &totalNucleotides,
-                       const KMerData &data);
+/// file of corrected reads, written by chunks
+class CorrectedReadsFile {
+ public:
+  CorrectedReadsFile(const std::string &fname, bool gzip);
+  ~CorrectedReadsFile();
+
+  /// prepares a chunk for writing, compresses it for gzipped output; thread-safe
+  std::string Pack(std::string chunk) const;
+  void Write(const std::string &chunk);
+
+ private:
+  static const int GZIP_LEVEL = 7;
+
+  std::ofstream ofs_;
+  bool gzip_;
+  bool empty_;
+};
 
 /// correct reads in a given file
 CorrectionStats CorrectReadFile(const KMerData &data,
-                         size_t &changedReads, size_t &changedNucleotides, size_t &uncorrectedNucleotides, size_t &totalNucleotides,
                          const std::string &fname,
-                         std::ofstream *outf_good, std::ofstream *outf_bad);
+                         CorrectedReadsFile &outf_good, CorrectedReadsFile &outf_bad);
 
 /// correct reads in a given pair of files
 CorrectionStats CorrectPairedReadFiles(const KMerData &data,
-                            size_t &changedReads, size_t &changedNucleotides, size_t &uncorrectedNucleotides, size_t &totalNucleotides,
                             const std::string &fnamel, const std::string &fnamer,
-                            std::ofstream * ofbadl, std::ofstream * ofcorl, std::ofstream * ofbadr, std::ofstream * ofcorr, std::ofstream * ofunp);
+                            CorrectedReadsFile &ofbadl, CorrectedReadsFile &ofcorl,
+                            CorrectedReadsFile &ofbadr, CorrectedReadsFile &ofcorr,
+                            CorrectedReadsFile &ofunp);
 /// correct all reads
 size_t CorrectAllReads();
 
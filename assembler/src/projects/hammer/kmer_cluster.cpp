@@ -19,6 +19,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <algorithm>
 
 using std::max_element;
@@ -28,6 +29,43 @@ namespace numeric = boost::numeric::ublas;
 
 using namespace hammer;
 
+struct KMerClustering::ThreadState {
+  // Scratch space reused by all the clusters of the thread
+  std::vector<hammer::ExpandedKMer> kmers;
+  std::vector<size_t> indices, best_indices, centers_in_cluster;
+  std::vector<Center> centers, best_centers;
+  std::vector<size_t> dists;
+  std::vector<double> loglike;
+  std::vector<bool> changed_center;
+  std::vector<std::vector<size_t> > blocks;
+  size_t nblocks = 0;
+
+  // Consensus k-mers which do not occur in the data
+  std::vector<KMer> new_kmers;
+  std::vector<KMerStat> new_stats;
+
+  numeric::matrix<uint64_t> errs;
+  std::ostringstream good_log, bad_log;
+  size_t gsingl = 0, tsingl = 0, tcsingl = 0, gcsingl = 0, tcls = 0, gcls = 0, tkmers = 0, tncls = 0;
+
+  ThreadState()
+      : errs(4, 4, 0) {}
+};
+
+// Per-thread logs are dumped once they grow that large
+static const std::streamoff LOG_FLUSH_SIZE = 1 << 20;
+
+static void FlushLog(std::ostringstream &log, std::ofstream &ofs) {
+  if (log.tellp() <= 0)
+    return;
+
+# pragma omp critical(kmer_cluster_log)
+  {
+    ofs << log.str();
+  }
+  log.str("");
+}
+
 std::string KMerClustering::GetGoodKMersFname() const {
   // FIXME: This is ugly!
   std::ostringstream tmp;
@@ -123,7 +161,8 @@ double KMerClustering::ClusterBIC(const std::vector<Center> &centers,
 
 
 double KMerClustering::lMeansClustering(unsigned l, const std::vector<hammer::ExpandedKMer> &kmers,
-                                        std::vector<size_t> &indices, std::vector<Center> &centers) {
+                                        std::vector<size_t> &indices, std::vector<Center> &centers,
+                                        ThreadState &state) {
   centers.resize(l); // there are l centers
 
   // if l==1 then clustering is trivial
@@ -184,9 +223,12 @@ double KMerClustering::lMeansClustering(unsigned l, const std::vector<hammer::Ex
   bool changed = true, improved = true;
 
   // auxiliary variables
-  std::vector<size_t> dists(l);
-  std::vector<double> loglike(l);
-  std::vector<bool> changedCenter(l);
+  std::vector<size_t> &dists = state.dists;
+  std::vector<double> &loglike = state.loglike;
+  std::vector<bool> &changedCenter = state.changed_center;
+  dists.resize(l);
+  loglike.assign(l, 0.0);
+  changedCenter.resize(l);
 
   while (changed && improved) {
     // fill everything with zeros
@@ -258,8 +300,8 @@ double KMerClustering::lMeansClustering(unsigned l, const std::vector<hammer::Ex
 }
 
 
-size_t KMerClustering::SubClusterSingle(const std::vector<size_t> & block, std::vector< std::vector<size_t> > & vec) {
-  size_t newkmers = 0;
+void KMerClustering::SubClusterSingle(const std::vector<size_t> & block, ThreadState &state) {
+  state.nblocks = 0;
 
   if (cfg::get().bayes_debug_output > 0) {
 #   pragma omp critical
@@ -272,7 +314,7 @@ size_t KMerClustering::SubClusterSingle(const std::vector<size_t> & block, std::
   }
 
   size_t origBlockSize = block.size();
-  if (origBlockSize == 0) return 0;
+  if (origBlockSize == 0) return;
 
   // Ad-hoc max cluster limit: we start to consider only those k-mers which
   // multiplicity differs from maximum multiplicity by 10x.
@@ -298,19 +340,23 @@ size_t KMerClustering::SubClusterSingle(const std::vector<size_t> & block, std::
   }
 
   // Prepare the expanded k-mer structure
-  std::vector<hammer::ExpandedKMer> kmers;
+  std::vector<hammer::ExpandedKMer> &kmers = state.kmers;
+  kmers.clear();
   for (size_t idx : block)
     kmers.emplace_back(data_.kmer(idx), data_[idx]);
 
   double bestLikelihood = -std::numeric_limits<double>::infinity();
-  std::vector<Center> bestCenters;
-  std::vector<size_t> indices(origBlockSize);
-  std::vector<size_t> bestIndices(origBlockSize);
+  std::vector<Center> &bestCenters = state.best_centers;
+  std::vector<size_t> &indices = state.indices;
+  std::vector<size_t> &bestIndices = state.best_indices;
+  bestCenters.clear();
+  indices.resize(origBlockSize);
+  bestIndices.resize(origBlockSize);
 
   unsigned max_l = cfg::get().bayes_hammer_mode ? 1 : (unsigned) origBlockSize;
-  std::vector<Center> centers;
+  std::vector<Center> &centers = state.centers;
   for (unsigned l = 1; l <= max_l; ++l) {
-    double curLikelihood = lMeansClustering(l, kmers, indices, centers);
+    double curLikelihood = lMeansClustering(l, kmers, indices, centers, state);
     if (cfg::get().bayes_debug_output > 0) {
       #pragma omp critical
       {
@@ -328,7 +374,8 @@ size_t KMerClustering::SubClusterSingle(const std::vector<size_t> & block, std::
   }
 
   // find if centers are in clusters
-  std::vector<size_t> centersInCluster(bestCenters.size(), -1u);
+  std::vector<size_t> &centersInCluster = state.centers_in_cluster;
+  centersInCluster.assign(bestCenters.size(), -1u);
   for (unsigned i = 0; i < origBlockSize; i++) {
     unsigned dist = kmers[i].hamdist(bestCenters[bestIndices[i]].center_);
     if (dist == 0)
@@ -404,7 +451,10 @@ size_t KMerClustering::SubClusterSingle(const std::vector<size_t> & block, std::
     if (bestCenters[k].count_ == 0)
       continue; // superfluous cluster with zero elements
 
-    std::vector<size_t> v;
+    if (state.blocks.size() == state.nblocks)
+      state.blocks.emplace_back();
+    std::vector<size_t> &v = state.blocks[state.nblocks++];
+    v.clear();
     if (bestCenters[k].count_ == 1) {
       for (size_t i = 0; i < origBlockSize; i++) {
         if (indices[i] == k) {
@@ -427,21 +477,24 @@ size_t KMerClustering::SubClusterSingle(const std::vector<size_t> & block, std::
         KMer newkmer(bestCenters[k].center_);
         size_t new_idx = data_.checking_seq_idx(newkmer);
         if (new_idx == -1ULL) {
-          #pragma omp critical
-          {
-            KMerStat kms(0 /* cnt */, 1.0 /* total quality */, NULL /*quality */);
-            kms.mark_good();
-            new_idx = data_.push_back(newkmer, kms);
-            newkmers += 1;
-          }
+          KMerStat kms(0 /* cnt */, 1.0 /* total quality */, NULL /*quality */);
+          kms.mark_good();
+          new_idx = data_.size() + state.new_kmers.size();
+          state.new_kmers.push_back(newkmer);
+          state.new_stats.push_back(kms);
         }
         v.insert(v.begin(), new_idx);
       }
     }
-    vec.push_back(v);
   }
+}
+
+KMerStat &KMerClustering::ClusterKMerStat(ThreadState &state, size_t idx) {
+  return idx < data_.size() ? data_[idx] : state.new_stats[idx - data_.size()];
+}
 
-  return newkmers;
+hammer::KMer KMerClustering::ClusterKMer(const ThreadState &state, size_t idx) const {
+  return idx < data_.size() ? data_.kmer(idx) : state.new_kmers[idx - data_.size()];
 }
 
 static void UpdateErrors(numeric::matrix<uint64_t> &m,
@@ -451,62 +504,49 @@ static void UpdateErrors(numeric::matrix<uint64_t> &m,
   }
 }
 
-size_t KMerClustering::ProcessCluster(const std::vector<size_t> &cur_class,
-                                      numeric::matrix<uint64_t> &errs,
-                                      std::ofstream &ofs, std::ofstream &ofs_bad,
-                                      size_t &gsingl, size_t &tsingl, size_t &tcsingl, size_t &gcsingl,
-                                      size_t &tcls, size_t &gcls, size_t &tkmers, size_t &tncls) {
-    size_t newkmers = 0;
-
+void KMerClustering::ProcessCluster(const std::vector<size_t> &cur_class,
+                                    const std::ofstream &ofs, const std::ofstream &ofs_bad,
+                                    ThreadState &state) {
     // No need for clustering for singletons
     if (cur_class.size() == 1) {
         size_t idx = cur_class[0];
         KMerStat &singl = data_[idx];
         if ((1-singl.total_qual) > cfg::get().bayes_singleton_threshold) {
             singl.mark_good();
-            gsingl += 1;
+            state.gsingl += 1;
 
-            if (ofs.good()) {
-#               pragma omp critical
-                {
-                    ofs << " good singleton: " << idx << "\n  " << singl << '\n';
-                }
-            }
+            if (ofs.good())
+                state.good_log << " good singleton: " << idx << "\n  " << singl << '\n';
         } else {
             if (cfg::get().correct_use_threshold && (1-singl.total_qual) > cfg::get().correct_threshold)
                 singl.mark_good();
             else
                 singl.mark_bad();
 
-            if (ofs_bad.good()) {
-#               pragma omp critical
-                {
-                    ofs_bad << " bad singleton: " << idx << "\n  " << singl << '\n';
-                }
-            }
+            if (ofs_bad.good())
+                state.bad_log << " bad singleton: " << idx << "\n  " << singl << '\n';
         }
-        tsingl += 1;
-        return 0;
+        state.tsingl += 1;
+        return;
     }
 
-    std::vector<std::vector<size_t> > blocksInPlace;
     if (cfg::get().bayes_debug_output) {
 #       pragma omp critical
         {
           std::cout << "process_SIN with size=" << cur_class.size() << std::endl;
         }
       }
-    newkmers += SubClusterSingle(cur_class, blocksInPlace);
+    SubClusterSingle(cur_class, state);
 
-    tncls += 1;
-    for (size_t m = 0; m < blocksInPlace.size(); ++m) {
-        const std::vector<size_t> &currentBlock = blocksInPlace[m];
+    state.tncls += 1;
+    for (size_t m = 0; m < state.nblocks; ++m) {
+        const std::vector<size_t> &currentBlock = state.blocks[m];
         if (currentBlock.size() == 0)
             continue;
 
         size_t cidx = currentBlock[0];
-        KMerStat &center = data_[cidx];
-        KMer ckmer = data_.kmer(cidx);
+        KMerStat &center = ClusterKMerStat(state, cidx);
+        KMer ckmer = ClusterKMer(state, cidx);
         double center_quality = 1 - center.total_qual;
 
         // Computing the overall quality of a cluster.
@@ -519,9 +559,9 @@ size_t KMerClustering::ProcessCluster(const std::vector<size_t> &cur_class,
         }
 
         if (currentBlock.size() == 1)
-            tcsingl += 1;
+            state.tcsingl += 1;
         else
-            tcls += 1;
+            state.tcls += 1;
 
         if ((center_quality > cfg::get().bayes_singleton_threshold &&
              cluster_quality > cfg::get().bayes_nonsingleton_threshold) ||
@@ -529,50 +569,36 @@ size_t KMerClustering::ProcessCluster(const std::vector<size_t> &cur_class,
           center.mark_good();
 
           if (currentBlock.size() == 1)
-              gcsingl += 1;
+              state.gcsingl += 1;
           else
-              gcls += 1;
-
-          if (ofs.good()) {
-#             pragma omp critical
-              {
-                  ofs << " center of good cluster (" << currentBlock.size() << ", " << cluster_quality << ")" << "\n  "
-                  << center << '\n';
-              }
-          }
+              state.gcls += 1;
+
+          if (ofs.good())
+              state.good_log << " center of good cluster (" << currentBlock.size() << ", " << cluster_quality << ")" << "\n  "
+                             << center << '\n';
         } else {
             if (cfg::get().correct_use_threshold && center_quality > cfg::get().correct_threshold)
                 center.mark_good();
             else
                 center.mark_bad();
-            if (ofs_bad.good()) {
-#               pragma omp critical
-                {
-                    ofs_bad << " center of bad cluster (" << currentBlock.size() << ", " << cluster_quality << ")" << "\n  "
-                            << center << '\n';
-                }
-            }
+            if (ofs_bad.good())
+                state.bad_log << " center of bad cluster (" << currentBlock.size() << ", " << cluster_quality << ")" << "\n  "
+                              << center << '\n';
         }
 
-        tkmers += currentBlock.size();
+        state.tkmers += currentBlock.size();
 
         for (size_t j = 1; j < currentBlock.size(); ++j) {
             size_t eidx = currentBlock[j];
             KMerStat &kms = data_[eidx];
 
-            UpdateErrors(errs, data_.kmer(eidx), ckmer);
+            UpdateErrors(state.errs, data_.kmer(eidx), ckmer);
 
-            if (ofs_bad.good()) {
-#               pragma omp critical
-                {
-                    ofs_bad << " part of cluster (" << currentBlock.size() << ", " << cluster_quality << ")" << "\n  "
-                            << kms << '\n';
-                }
-            }
+            if (ofs_bad.good())
+                state.bad_log << " part of cluster (" << currentBlock.size() << ", " << cluster_quality << ")" << "\n  "
+                              << kms << '\n';
         }
     }
-
-    return newkmers;
 }
 
 
@@ -598,53 +624,76 @@ void KMerClustering::process(const std::string &Prefix) {
 
   // Open and read index file
   MMappedRecordReader<size_t> findex(Prefix + ".idx",  /* unlink */ !debug_, -1ULL);
-
-  std::vector<numeric::matrix<uint64_t> > errs(nthreads_, numeric::matrix<double>(4, 4, 0.0));
-
-# pragma omp parallel for shared(ofs, ofs_bad, errs) num_threads(nthreads_) schedule(guided) reduction(+:newkmers, gsingl, tsingl, tcsingl, gcsingl, tcls, gcls, tkmers, tncls)
-  for (size_t chunk = 0; chunk < nthreads_ * nthreads_; ++chunk) {
-      size_t *current = findex.data() + findex.size() * chunk / nthreads_ / nthreads_;
-      size_t *next = findex.data() + findex.size() * (chunk + 1)/ nthreads_ / nthreads_;
-      std::ifstream is(Prefix, std::ios::in | std::ios::binary);
-
-      // Calculate how much we need to seek
-      size_t soff = 0;
-      for (size_t *csz = findex.data(); csz != current; ++csz)
-          soff += *csz;
-
-      // Now see the stream and start processing
-      is.seekg(soff * sizeof(size_t));
-
-      for (; current != next; ++current) {
-          std::vector<size_t> cluster(*current);
-          VERIFY(is.good());
-          is.read((char*)&cluster[0], *current * sizeof(cluster[0]));
-
-          // Underlying code expected classes to be sorted in count decreasing order.
-          std::sort(cluster.begin(), cluster.end(), KMerStatCountComparator(data_));
-
-          newkmers += ProcessCluster(cluster,
-                                     errs[omp_get_thread_num()],
-                                     ofs, ofs_bad,
-                                     gsingl, tsingl, tcsingl, gcsingl,
-                                     tcls, gcls, tkmers, tncls);
-      }
+  MMappedRecordReader<size_t> fclusters(Prefix,  /* unlink */ !debug_, -1ULL);
+
+  size_t nclusters = findex.size();
+  std::vector<size_t> offsets(nclusters + 1, 0);
+  for (size_t i = 0; i < nclusters; ++i)
+    offsets[i + 1] = offsets[i] + findex[i];
+  VERIFY(offsets[nclusters] == fclusters.size());
+
+  // Non-singleton clusters are processed first, the largest ones at the head, so
+  // that the few huge clusters do not end up being the tail of the schedule
+  std::vector<size_t> big_clusters;
+  for (size_t i = 0; i < nclusters; ++i) {
+    if (findex[i] > 1)
+      big_clusters.push_back(i);
   }
+  std::sort(big_clusters.begin(), big_clusters.end(),
+            [&](size_t a, size_t b) { return findex[a] > findex[b]; });
+
+  std::vector<ThreadState> states(nthreads_);
+# pragma omp parallel num_threads(nthreads_)
+  {
+    ThreadState &state = states[omp_get_thread_num()];
+    std::vector<size_t> cluster;
+    auto process_cluster = [&](size_t i) {
+      cluster.assign(fclusters.data() + offsets[i], fclusters.data() + offsets[i + 1]);
+
+      // Underlying code expected classes to be sorted in count decreasing order.
+      std::sort(cluster.begin(), cluster.end(), KMerStatCountComparator(data_));
+
+      ProcessCluster(cluster, ofs, ofs_bad, state);
+
+      if (state.good_log.tellp() > LOG_FLUSH_SIZE)
+        FlushLog(state.good_log, ofs);
+      if (state.bad_log.tellp() > LOG_FLUSH_SIZE)
+        FlushLog(state.bad_log, ofs_bad);
+    };
+
+    // Threads done with the large clusters proceed to the singletons
+#   pragma omp for schedule(dynamic) nowait
+    for (size_t i = 0; i < big_clusters.size(); ++i)
+      process_cluster(big_clusters[i]);
+
+#   pragma omp for schedule(dynamic, 1024)
+    for (size_t i = 0; i < nclusters; ++i) {
+      if (findex[i] <= 1)
+        process_cluster(i);
+    }
 
-  if (!debug_) {
-      int res = unlink(Prefix.c_str());
-      VERIFY_MSG(res == 0,
-                 "unlink(2) failed. Reason: " << strerror(errno) << ". Error code: " << errno);
+    FlushLog(state.good_log, ofs);
+    FlushLog(state.bad_log, ofs_bad);
   }
 
-  for (unsigned i = 1; i < nthreads_; ++i)
-    errs[0] += errs[i];
+  // New consensus k-mers are appended to the data only now, so that it stays
+  // immutable during the parallel processing
+  numeric::matrix<uint64_t> errs(4, 4, 0);
+  for (ThreadState &state : states) {
+    for (size_t i = 0; i < state.new_kmers.size(); ++i)
+      data_.push_back(state.new_kmers[i], state.new_stats[i]);
+    newkmers += state.new_kmers.size();
+
+    errs += state.errs;
+    gsingl += state.gsingl; tsingl += state.tsingl; tcsingl += state.tcsingl; gcsingl += state.gcsingl;
+    tcls += state.tcls; gcls += state.gcls; tkmers += state.tkmers; tncls += state.tncls;
+  }
 
-  numeric::matrix<uint64_t> rowsums = prod(errs[0], numeric::scalar_matrix<double>(4, 1, 1));
+  numeric::matrix<uint64_t> rowsums = prod(errs, numeric::scalar_matrix<double>(4, 1, 1));
   numeric::matrix<double> err(4, 4);
   for (unsigned i = 0; i < 4; ++i)
     for (unsigned j = 0; j < 4; ++j)
-      err(i, j) = 1.0 * (double)errs[0](i, j) / (double)rowsums(i, 0);
+      err(i, j) = 1.0 * (double)errs(i, j) / (double)rowsums(i, 0);
 
   INFO("Subclustering done. Total " << newkmers << " non-read kmers were generated.");
   INFO("Subclustering statistics:");
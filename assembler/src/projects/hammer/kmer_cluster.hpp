@@ -40,6 +40,9 @@ private:
     hammer::ExpandedSeq center_;
     size_t count_;
   };
+
+  // Per-thread scratch vectors, results and statistics, merged after the subclustering
+  struct ThreadState;
     
   double ClusterBIC(const std::vector<Center> &centers,
                     const std::vector<size_t> &indices, const std::vector<hammer::ExpandedKMer> &kmers) const;
@@ -51,18 +54,22 @@ private:
     * @return the resulting likelihood of this clustering
     */
   double lMeansClustering(unsigned l, const std::vector<hammer::ExpandedKMer> &kmers,
-                          std::vector<size_t> & indices, std::vector<Center> & centers);
+                          std::vector<size_t> & indices, std::vector<Center> & centers,
+                          ThreadState &state);
 
-  size_t SubClusterSingle(const std::vector<size_t> & block, std::vector< std::vector<size_t> > & vec);
+  // Splits the block into subclusters, stored to the first state.nblocks of state.blocks
+  void SubClusterSingle(const std::vector<size_t> & block, ThreadState &state);
 
   std::string GetGoodKMersFname() const;
   std::string GetBadKMersFname() const;
 
-  size_t ProcessCluster(const std::vector<size_t> &cur_class,
-                        boost::numeric::ublas::matrix<uint64_t> &errs,
-                        std::ofstream &ofs, std::ofstream &ofs_bad,
-                        size_t &gsingl, size_t &tsingl, size_t &tcsingl, size_t &gcsingl,
-                        size_t &tcls, size_t &gcls, size_t &tkmers, size_t &tncls);
+  // Consensus k-mers absent from the data get indices past its end until merged
+  KMerStat &ClusterKMerStat(ThreadState &state, size_t idx);
+  hammer::KMer ClusterKMer(const ThreadState &state, size_t idx) const;
+
+  void ProcessCluster(const std::vector<size_t> &cur_class,
+                      const std::ofstream &ofs, const std::ofstream &ofs_bad,
+                      ThreadState &state);
 
 private:
   DECL_LOGGER("Hamming Subclustering");
@@ -61,10 +61,10 @@ class BufferFiller {
   BufferFiller(HammerFilteringKMerSplitter &splitter)
       : splitter_(splitter) {}
 
-  bool operator()(std::unique_ptr<Read> r) {
+  bool operator()(const Read &r) {
     int trim_quality = cfg::get().input_trim_quality;
 
-    Read cr = *r;
+    Read cr = r;
     size_t sz = cr.trimNsAndBadQuality(trim_quality);
   
     if (sz < hammer::K)
@@ -160,11 +160,11 @@ class KMerDataFiller {
   KMerDataFiller(KMerData &data)
       : data_(data) {}
 
-  bool operator()(std::unique_ptr<Read> r) {
+  bool operator()(const Read &r) {
     uint8_t trim_quality = (uint8_t)cfg::get().input_trim_quality;
 
     // FIXME: Get rid of this
-    Read cr = *r;
+    Read cr = r;
     size_t sz = cr.trimNsAndBadQuality(trim_quality);
 
     if (sz < hammer::K)
@@ -195,11 +195,11 @@ class KMerMultiplicityCounter {
 
   ~KMerMultiplicityCounter() {}
 
-    bool operator()(std::unique_ptr<Read> r) {
+    bool operator()(const Read &r) {
       uint8_t trim_quality = (uint8_t)cfg::get().input_trim_quality;
 
       // FIXME: Get rid of this
-      Read cr = *r;
+      Read cr = r;
       size_t sz = cr.trimNsAndBadQuality(trim_quality);
 
       if (sz < hammer::K)
@@ -233,11 +233,11 @@ class KMerCountEstimator {
 
   ~KMerCountEstimator() {}
 
-    bool operator()(std::unique_ptr<Read> r) {
+    bool operator()(const Read &r) {
       uint8_t trim_quality = (uint8_t)cfg::get().input_trim_quality;
 
       // FIXME: Get rid of this
-      Read cr = *r;
+      Read cr = r;
       size_t sz = cr.trimNsAndBadQuality(trim_quality);
 
       if (sz < hammer::K)
@@ -37,11 +37,15 @@ struct KMerStat;
 
 static inline unsigned hamdistKMer(const hammer::KMer &x, const hammer::KMer &y,
                                    unsigned tau = hammer::K) {
+  static_assert(sizeof(hammer::KMer::DataType) == sizeof(uint64_t), "64-bit k-mer storage expected");
+  // Nucleotides are packed by two bits (unused tail is zero), so the mismatches are
+  // the two-bit groups with any bit set in xor
+  const uint64_t LOW_BITS = 0x5555555555555555ull;
   unsigned dist = 0;
-  for (unsigned i = 0; i < hammer::K; ++i) {
-    if (x[i] != y[i]) {
-      ++dist; if (dist > tau) return dist;
-    }
+  for (size_t i = 0; i < hammer::KMer::DataSize; ++i) {
+    uint64_t diff = x.data()[i] ^ y.data()[i];
+    dist += (unsigned) __builtin_popcountll((diff | (diff >> 1)) & LOW_BITS);
+    if (dist > tau) return dist;
   }
   return dist;
 }
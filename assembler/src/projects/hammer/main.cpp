@@ -26,6 +26,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <memory>
 #include <fstream>
 #include <sstream>
 #include <string>
@@ -33,6 +34,7 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstdio>
 #include <cstdlib>
 
 std::vector<uint32_t> * Globals::subKMerPositions = NULL;
@@ -195,14 +197,27 @@ int main(int argc, char * argv[]) {
       if (cfg::get().expand_do || do_everything) {
         unsigned expand_nthreads = std::min(cfg::get().general_max_nthreads, cfg::get().expand_nthreads);
         INFO("Starting solid k-mers expansion in " << expand_nthreads << " threads.");
+        // Reads of the previous iteration which may still produce new solid k-mers
+        std::string frontier;
         for (unsigned expand_iter_no = 0; expand_iter_no < cfg::get().expand_max_iterations; ++expand_iter_no) {
-          Expander expander(*Globals::kmer_data);
-          const io::DataSet<> &dataset = cfg::get().dataset;
-          for (auto I = dataset.reads_begin(), E = dataset.reads_end(); I != E; ++I) {
-            ireadstream irs(*I, cfg::get().input_qvoffset);
+          bool last_iter = expand_iter_no + 1 == cfg::get().expand_max_iterations;
+          std::string next_frontier = hammer::getFilename(cfg::get().input_working_dir, Globals::iteration_no, "expand.frontier", expand_iter_no);
+          std::unique_ptr<FrontierWriter> frontier_writer(last_iter ? nullptr : new FrontierWriter(next_frontier));
+          Expander expander(*Globals::kmer_data, frontier_writer.get());
+          if (frontier.empty()) {
+            const io::DataSet<> &dataset = cfg::get().dataset;
+            for (auto I = dataset.reads_begin(), E = dataset.reads_end(); I != E; ++I) {
+              ireadstream irs(*I, cfg::get().input_qvoffset);
+              hammer::ReadProcessor rp(expand_nthreads);
+              rp.Run(irs, expander);
+              VERIFY_MSG(rp.read() == rp.processed(), "Queue unbalanced");
+            }
+          } else {
+            FrontierReader irs(frontier);
             hammer::ReadProcessor rp(expand_nthreads);
             rp.Run(irs, expander);
             VERIFY_MSG(rp.read() == rp.processed(), "Queue unbalanced");
+            std::remove(frontier.c_str());
           }
 
           if (cfg::get().expand_write_each_iteration) {
@@ -216,9 +231,17 @@ int main(int argc, char * argv[]) {
           }
 
           INFO("Solid k-mers iteration " << expand_iter_no << " produced " << expander.changed() << " new k-mers.");
+          frontier.clear();
+          if (frontier_writer) {
+            INFO(frontier_writer->size() << " reads may produce more of them.");
+            frontier_writer.reset();
+            frontier = next_frontier;
+          }
           if (expander.changed() < 10)
             break;
         }
+        if (!frontier.empty())
+          std::remove(frontier.c_str());
         INFO("Solid k-mers finalized");
 
         if (cfg::get().general_debug) {
@@ -9,6 +9,7 @@
 #include <boost/math/special_functions/binomial.hpp>
 #include <boost/math/special_functions/gamma.hpp>
 #include <boost/math/special_functions/trigamma.hpp>
+#include <algorithm>
 #include <vector>
 #include "kmer_data.hpp"
 #include "thread_utils.h"
@@ -76,7 +77,12 @@ class GammaMixture {
 
 class PoissonGammaDistribution {
  private:
-  const GammaDistribution& prior_;
+  double shape_;
+  double rate_;
+  double log_gamma_at_shape_;
+  // a * log(b) and log(b + 1), common for all counts
+  double shape_log_rate_;
+  double log_rate_next_;
   static std::array<double, 100000> log_gamma_integer_cache_;
 
  private:
@@ -89,42 +95,35 @@ class PoissonGammaDistribution {
   }
 
  public:
-  PoissonGammaDistribution(const GammaDistribution& prior) : prior_(prior) {}
+  PoissonGammaDistribution(const GammaDistribution& prior)
+      : shape_(prior.GetShape()),
+        rate_(prior.GetRate()),
+        log_gamma_at_shape_(prior.LogGammaAtShape()),
+        shape_log_rate_(shape_ * log(rate_)),
+        log_rate_next_(log(rate_ + 1)) {}
 
   inline double PartialLogLikelihood(size_t count) const {
-    const double a = prior_.GetShape();
-    const double b = prior_.GetRate();
-
     double ll = 0.0;
-    ll += a * log(b) - (a + (double)count) * log(b + 1);
-    ll +=
-        boost::math::lgamma(prior_.GetShape() + (double)count) - prior_.LogGammaAtShape();
+    ll += shape_log_rate_ - (shape_ + (double)count) * log_rate_next_;
+    ll += boost::math::lgamma(shape_ + (double)count) - log_gamma_at_shape_;
     return ll;
   }
 
   inline double LogLikelihood(size_t count) const {
-    const double a = prior_.GetShape();
-    const double b = prior_.GetRate();
-
     double ll = 0.0;
-    ll += a * log(b) - (a + (double)count) * log(b + 1);
-    ll += boost::math::lgamma(prior_.GetShape() + ((double)count)) - IntLogGamma(count) -
-          prior_.LogGammaAtShape();
+    ll += shape_log_rate_ - (shape_ + (double)count) * log_rate_next_;
+    ll += boost::math::lgamma(shape_ + ((double)count)) - IntLogGamma(count) -
+          log_gamma_at_shape_;
 
     return ll;
   }
 
   inline double Quantile(double p) const {
-    const double a = prior_.GetShape();
-    const double b = prior_.GetRate();
-    return boost::math::ibeta_inva(a, 1.0 / (1.0 + b), 1.0 - p);
+    return boost::math::ibeta_inva(shape_, 1.0 / (1.0 + rate_), 1.0 - p);
   }
 
   inline double Cumulative(size_t count) const {
-    const double a = prior_.GetShape();
-    const double b = prior_.GetRate();
-
-    return 1.0 - boost::math::ibeta((double)count + 1, a, 1.0 / (1.0 + b));
+    return 1.0 - boost::math::ibeta((double)count + 1, shape_, 1.0 / (1.0 + rate_));
   }
 };
 
@@ -840,15 +839,30 @@ class TClusterModelEstimator {
       sum2 += (double)count * (double)count;
     }
 
+    // k-mers of a read share many counts, so digamma and trigamma are
+    // evaluated once per distinct count
+    std::vector<size_t> sorted(counts);
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<double> values, multiplicities;
+    for (size_t i = 0; i < sorted.size();) {
+      size_t j = i;
+      while (j < sorted.size() && sorted[j] == sorted[i]) {
+        ++j;
+      }
+      values.push_back((double)sorted[i]);
+      multiplicities.push_back((double)(j - i));
+      i = j;
+    }
+
     GammaDistribution prior =
         TClusterModelEstimator::MomentMethodEstimator(sum, sum2, (double)observations);
 
     for (unsigned i = 0, steps = 0; i < 10; ++i, ++steps) {
       double digammaSum = 0;
       double trigammaSum = 0;
-      for (auto count : counts) {
-        digammaSum += boost::math::digamma((double)count + prior.GetShape());
-        trigammaSum += boost::math::trigamma((double)count + prior.GetShape());
+      for (size_t k = 0; k < values.size(); ++k) {
+        digammaSum += multiplicities[k] * boost::math::digamma(values[k] + prior.GetShape());
+        trigammaSum += multiplicities[k] * boost::math::trigamma(values[k] + prior.GetShape());
       }
 
       auto direction = MoveDirection(prior.GetShape(), sum, (double)observations,
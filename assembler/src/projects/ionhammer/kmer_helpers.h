@@ -53,8 +53,8 @@ class SetFiller {
  public:
   SetFiller(std::unordered_set<hammer::HKMer>& kmers) : kmers_(kmers) {}
 
-  bool operator()(std::unique_ptr<io::SingleRead>&& read) {
-    ProcessString(read->GetSequenceString());
+  bool operator()(const io::SingleRead &read) {
+    ProcessString(read.GetSequenceString());
     return false;
   }
 };
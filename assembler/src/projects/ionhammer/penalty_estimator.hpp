@@ -62,6 +62,21 @@ class GammaPoissonLikelihoodCalcer {
   double correction_penalty_;
   double bad_kmer_penalty_;
   const KMerData& data_;
+  // Log-likelihoods of the clamped noise counts, filled on demand. The calcer
+  // is created for a single read, so it is not shared between threads.
+  mutable std::vector<double> noise_log_likelihoods_;
+
+  inline double NoiseLogLikelihood(size_t count) const {
+    const size_t idx = count - noise_quantiles_lower_;
+    if (count < noise_quantiles_lower_ || idx >= noise_log_likelihoods_.size()) {
+      return count_distribution_.LogLikelihood(count);
+    }
+    double& ll = noise_log_likelihoods_[idx];
+    if (std::isnan(ll)) {
+      ll = count_distribution_.LogLikelihood(count);
+    }
+    return ll;
+  }
 
  public:
   class PenaltyState {
@@ -134,6 +149,12 @@ class GammaPoissonLikelihoodCalcer {
     const double eps = cfg::get().count_dist_eps;
     noise_quantiles_lower_ = (size_t)max(count_distribution_.Quantile(eps), 1.0);
     noise_quantile_upper_ = (size_t)count_distribution_.Quantile(1.0 - eps);
+    if (noise_quantiles_lower_ <= noise_quantile_upper_) {
+      const size_t max_table_size = 1 << 16;
+      noise_log_likelihoods_.assign(
+          std::min(noise_quantile_upper_ - noise_quantiles_lower_ + 1, max_table_size),
+          std::numeric_limits<double>::quiet_NaN());
+    }
 
     correction_penalty_ = cfg::get().correction_penalty;
     bad_kmer_penalty_ = cfg::get().bad_kmer_penalty;
@@ -182,7 +203,7 @@ class GammaPoissonLikelihoodCalcer {
 
       // state.Likelihood += dist * log(Model.ErrorRate(event.FixedSize));
       state.likelihood_ += (double)state.hkmer_distance_to_read_ * correction_penalty_;
-      state.likelihood_ += count_distribution_.LogLikelihood(cnt);
+      state.likelihood_ += NoiseLogLikelihood(cnt);
     }
 
     if (!is_good) {
@@ -23,6 +23,10 @@ namespace debruijn_graph {
 
 using namespace omnigraph::de;
 
+static const size_t GB = 1 << 30;
+// Part of the memory limit the cached graph distances of a library may take
+static const size_t DISTANCE_CACHE_MEMORY_SHARE = 8;
+
 template<class Graph>
 void estimate_with_estimator(const Graph &graph,
                              const omnigraph::de::AbstractDistanceEstimator& estimator,
@@ -100,14 +104,12 @@ void RefinePairedInfo(const Graph& graph, PairedInfoIndexT<Graph>& clustered_ind
 void estimate_scaffolding_distance(conj_graph_pack& gp,
                        const io::SequencingLibrary<config::LibraryData> &lib,
                        const UnclusteredPairedIndexT& paired_index,
+                       const GraphDistanceFinder& dist_finder,
                        PairedIndexT& scaffolding_index) {
     INFO("Filling scaffolding index");
 
     double is_var = lib.data().insert_size_deviation;
-    size_t delta = size_t(is_var);
     size_t linkage_distance = size_t(cfg::get().de.linkage_distance_coeff * is_var);
-    GraphDistanceFinder dist_finder(gp.g, (size_t) math::round(lib.data().mean_insert_size),
-                                    lib.data().unmerged_read_length, delta);
     size_t max_distance = size_t(cfg::get().de.max_distance_coeff_scaff * is_var);
 
     DEBUG("Retaining insert size distribution for it");
@@ -137,12 +139,11 @@ void estimate_scaffolding_distance(conj_graph_pack& gp,
 void estimate_distance(conj_graph_pack& gp,
                        const io::SequencingLibrary<config::LibraryData> &lib,
                        const UnclusteredPairedIndexT& paired_index,
+                       const GraphDistanceFinder& dist_finder,
                        PairedIndexT& clustered_index) {
 
     const config::debruijn_config& config = cfg::get();
-    size_t delta = size_t(lib.data().insert_size_deviation);
     size_t linkage_distance = size_t(config.de.linkage_distance_coeff * lib.data().insert_size_deviation);
-    GraphDistanceFinder dist_finder(gp.g,  (size_t)math::round(lib.data().mean_insert_size), lib.data().unmerged_read_length, delta);
     size_t max_distance = size_t(config.de.max_distance_coeff * lib.data().insert_size_deviation);
 
     PairInfoWeightChecker<Graph> checker(gp.g, config.de.clustered_filter_threshold);
@@ -168,14 +169,22 @@ void estimate_distance(conj_graph_pack& gp,
 }
 
 void DistanceEstimation::run(conj_graph_pack &gp, const char*) {
+    gp.EnsureCompactLayout();
     for (size_t i = 0; i < cfg::get().ds.reads.lib_count(); ++i)
         if (cfg::get().ds.reads[i].type() == io::LibraryType::PairedEnd) {
             if (cfg::get().ds.reads[i].data().mean_insert_size != 0.0) {
                 INFO("Processing library #" << i);
-                estimate_distance(gp, cfg::get().ds.reads[i], gp.paired_indices[i],
+                const auto &lib = cfg::get().ds.reads[i];
+                // Shared by both estimators, so graph distances computed for the first one are reused
+                GraphDistanceFinder dist_finder(gp.g, (size_t) math::round(lib.data().mean_insert_size),
+                                                lib.data().unmerged_read_length,
+                                                size_t(lib.data().insert_size_deviation),
+                                                cfg::get().max_memory * GB / DISTANCE_CACHE_MEMORY_SHARE,
+                                                &gp.compact_layout);
+                estimate_distance(gp, lib, gp.paired_indices[i], dist_finder,
                                   gp.clustered_indices[i]);
                 if (cfg::get().pe_params.param_set.scaffolder_options.cluster_info) {
-                    estimate_scaffolding_distance(gp, cfg::get().ds.reads[i], gp.paired_indices[i],
+                    estimate_scaffolding_distance(gp, lib, gp.paired_indices[i], dist_finder,
                                                   gp.scaffolding_indices[i]);
                 }
             }
@@ -305,6 +305,9 @@ void PacbioAlignLibrary(const conj_graph_pack& gp,
 
     INFO("For library of " << lib_for_info);
     aligner.stats().Report();
+    const auto &distance_cache = galigner.pac_index().distance_cache();
+    INFO("Vertex distance cache: " << distance_cache.hits() << " hits, "
+                                   << distance_cache.misses() << " misses");
     INFO("Aligning of " << lib_for_info <<" finished");
 }
 
@@ -218,6 +218,10 @@ void assemble_genome() {
         INFO("Will need read mapping, kmer mapper will be attached");
         conj_gp.kmer_mapper.Attach();
     }
+    if (cfg::get().edge_nucl_arena) {
+        INFO("Edge sequences will be stored in the arena");
+        conj_gp.g.EnableNuclArena();
+    }
 
     // Build the pipeline
     SPAdes.add<ReadConversion>();
@@ -23,6 +23,7 @@ static void PEResolving(conj_graph_pack& gp) {
                                                   cfg::get().avoid_rc_connections,
                                                   cfg::get().use_scaffolder);
 
+    gp.EnsureCompactLayout();
     path_extend::PathExtendLauncher exspander(cfg::get().ds, params, gp);
     exspander.Launch();
 }
@@ -702,6 +702,12 @@ def add_hidden_args(pgroup_hidden):
                                help="sets size of read buffer for graph construction"
                                if show_help_hidden else argparse.SUPPRESS,
                                action="store")
+    pgroup_hidden.add_argument("--compress-bin-reads",
+                               dest="compress_bin_reads",
+                               default=False,
+                               help="stores internal binary copies of reads compressed"
+                               if show_help_hidden else argparse.SUPPRESS,
+                               action="store_true")
     pgroup_hidden.add_argument("--large-genome",
                                dest="large_genome",
                                default=False,
@@ -916,6 +922,7 @@ def add_to_cfg(cfg, log, bin_home, spades_home, args):
         cfg["assembly"].__dict__["save_gp"] = args.save_gp
         if args.read_buffer_size:
             cfg["assembly"].__dict__["read_buffer_size"] = args.read_buffer_size
+        cfg["assembly"].__dict__["compress_bin_reads"] = args.compress_bin_reads
         cfg["assembly"].__dict__["correct_scaffolds"] = options_storage.correct_scaffolds
 
     # corrector can work only if contigs exist (not only error correction)
@@ -98,6 +98,18 @@ def substitute_params(filename, var_dict, log):
     f.close()
 
 
+# for optional keys, which config templates may omit
+def substitute_or_append_param(filename, var, value, log):
+    lines = file_lines(filename)
+    if var in vars_from_lines(lines):
+        substitute_params(filename, {var: value}, log)
+    else:
+        with open(filename, "a") as f:
+            if lines and not lines[-1].endswith("\n"):
+                f.write("\n")
+            f.write("%s %s\n" % (var, value))
+
+
 # configs with more priority should go first in parameters
 def merge_configs(*cfgs):
     res = cfg_placeholder()
@@ -41,6 +41,8 @@ class ECRunningToolStage(stage.Stage):
         if "read_buffer_size" in cfg.__dict__:
             subst_dict["count_split_buffer"] = cfg.read_buffer_size
         process_cfg.substitute_params(filename, subst_dict, log)
+        process_cfg.substitute_or_append_param(filename, "correct_gzip_output",
+                                               process_cfg.bool_to_str(cfg.gzip_output), log)
 
     def prepare_config_ih(self, filename, cfg, ext_python_modules_home):
         addsitedir(ext_python_modules_home)
@@ -106,7 +108,8 @@ class ErrorCorrectionCompressingStage(stage.Stage):
                 "--output_dir", cfg.output_dir]
         if cfg.not_used_dataset_yaml_filename != "":
             args += ["--not_used_yaml_file", cfg.not_used_dataset_yaml_filename]
-        if cfg.gzip_output:
+        # BayesHammer compresses its output itself
+        if cfg.gzip_output and cfg.iontorrent:
             args.append("--gzip_output")
 
         command = [commands_parser.Command(STAGE="corrected reads compression",
@@ -87,6 +87,9 @@ def prepare_config_spades(filename, cfg, log, additional_contigs_fname, K, stage
     if "series_analysis" in cfg.__dict__:
         subst_dict["series_analysis"] = cfg.series_analysis
     process_cfg.substitute_params(filename, subst_dict, log)
+    if "compress_bin_reads" in cfg.__dict__:
+        process_cfg.substitute_or_append_param(filename, "compress_bin_reads",
+                                               bool_to_str(cfg.compress_bin_reads), log)
 
 
 def prepare_config_rnaspades(filename, log):
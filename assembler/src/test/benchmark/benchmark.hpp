@@ -0,0 +1,121 @@
+//***************************************************************************
+//* Copyright (c) 2019 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+
+// Keeps the compiler from dropping computations whose results are unused
+template<class T>
+inline void DoNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Result {
+    std::string name;
+    size_t iterations;
+    size_t items;
+    double seconds;
+
+    double ns_per_item() const {
+        return seconds * 1e9 / double(iterations * items);
+    }
+};
+
+// Every benchmark body processes `items` items per call and is called until
+// the total time reaches min_time. Setup should happen outside of the body.
+class Runner {
+    std::string filter_;
+    double min_time_;
+    std::vector<Result> results_;
+
+    typedef std::chrono::steady_clock clock;
+
+    static double Measure(const std::function<void()> &body, size_t iterations) {
+        auto start = clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+            body();
+        return std::chrono::duration<double>(clock::now() - start).count();
+    }
+
+public:
+    Runner(const std::string &filter, double min_time)
+            : filter_(filter), min_time_(min_time) {}
+
+    bool enabled(const std::string &name) const {
+        return filter_.empty() || name.find(filter_) != std::string::npos;
+    }
+
+    void Run(const std::string &name, size_t items, const std::function<void()> &body) {
+        if (!enabled(name))
+            return;
+
+        // Warm up caches and find out the iteration count taking min_time
+        body();
+        size_t iterations = 1;
+        double seconds = Measure(body, iterations);
+        while (seconds < min_time_) {
+            size_t next = (seconds > 0 ? size_t(1.4 * min_time_ / seconds * double(iterations)) : 10 * iterations);
+            iterations = std::max(iterations + 1, std::min(next, 10 * iterations));
+            seconds = Measure(body, iterations);
+        }
+
+        results_.push_back({ name, iterations, items, seconds });
+    }
+
+    const std::vector<Result> &results() const { return results_; }
+
+    // Quoted JSON string literal
+    static std::string JSONString(const std::string &s) {
+        static const char HEX[] = "0123456789abcdef";
+        std::string res = "\"";
+        for (char c : s) {
+            switch (c) {
+                case '"': res += "\\\""; break;
+                case '\\': res += "\\\\"; break;
+                case '\n': res += "\\n"; break;
+                case '\r': res += "\\r"; break;
+                case '\t': res += "\\t"; break;
+                default:
+                    if ((unsigned char) c < 0x20) {
+                        res += "\\u00";
+                        res += HEX[(unsigned char) c >> 4];
+                        res += HEX[(unsigned char) c & 0xf];
+                    } else {
+                        res += c;
+                    }
+            }
+        }
+        return res + "\"";
+    }
+
+    void WriteJSON(std::ostream &os, const std::vector<std::pair<std::string, std::string>> &context) const {
+        os << "{\n  \"context\": {";
+        for (size_t i = 0; i < context.size(); ++i)
+            os << (i ? "," : "") << "\n    " << JSONString(context[i].first) << ": " << JSONString(context[i].second);
+        os << "\n  },\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const Result &r = results_[i];
+            os << (i ? "," : "") << "\n    {"
+               << "\"name\": " << JSONString(r.name) << ", "
+               << "\"iterations\": " << r.iterations << ", "
+               << "\"items_per_iteration\": " << r.items << ", "
+               << "\"real_time_ns\": " << r.seconds * 1e9 / double(r.iterations) << ", "
+               << "\"ns_per_item\": " << r.ns_per_item() << ", "
+               << "\"items_per_second\": " << double(r.iterations * r.items) / r.seconds
+               << "}";
+        }
+        os << "\n  ]\n}\n";
+    }
+};
+
+}
@@ -0,0 +1,394 @@
+//***************************************************************************
+//* Copyright (c) 2019 Saint Petersburg State University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//***************************************************************************
+
+// Micro-benchmarks of the hot k-mer and graph primitives on synthetic
+// deterministic inputs. Results are reported in JSON.
+
+#include "benchmark.hpp"
+
+#include "adt/concurrent_dsu.hpp"
+#include "assembly_graph/dijkstra/dijkstra_helper.hpp"
+#include "io/reads/rc_reader_wrapper.hpp"
+#include "io/reads/vector_reader.hpp"
+#include "modules/alignment/sequence_mapper.hpp"
+#include "modules/graph_construction.hpp"
+#include "paired_info/paired_info.hpp"
+#include "sequence/sequence.hpp"
+#include "utils/extension_index/kmer_extension_index_builder.hpp"
+#include "utils/kmer_mph/kmer_index_builder.hpp"
+#include "utils/logger/log_writers.hpp"
+#include "utils/parallel/openmp_wrapper.h"
+
+#include "version.hpp"
+
+#include <clipp/clipp.h>
+
+#include <fstream>
+#include <iostream>
+#include <random>
+
+using namespace debruijn_graph;
+
+struct bcfg {
+    bcfg() : k(55), genome_size(1 << 20), nthreads(omp_get_max_threads()),
+             min_time(0.5), seed(42) {}
+
+    unsigned k;
+    size_t genome_size;
+    unsigned nthreads;
+    double min_time;
+    unsigned seed;
+    std::string filter;
+    std::string outfile;
+    std::string tmpdir;
+};
+
+static void process_cmdline(int argc, char **argv, bcfg &cfg) {
+    using namespace clipp;
+
+    auto cli = (
+        (option("-k", "--kmer") & integer("value", cfg.k)) % "k-mer length (default: 55)",
+        (option("-g", "--genome-size") & integer("value", cfg.genome_size)) % "synthetic genome length (default: 1M)",
+        (option("-t", "--threads") & integer("value", cfg.nthreads)) % "# of threads to use (default: max_threads)",
+        (option("-m", "--min-time") & number("seconds", cfg.min_time)) % "minimal time to run every benchmark (default: 0.5)",
+        (option("-s", "--seed") & integer("value", cfg.seed)) % "seed of the synthetic inputs (default: 42)",
+        (option("-f", "--filter") & value("substring", cfg.filter)) % "run only benchmarks with the given substring in the name",
+        (option("-o", "--output") & value("file", cfg.outfile)) % "JSON output file (default: stdout)",
+        (option("--tmpdir") & value("dir", cfg.tmpdir)) % "scratch directory to use (default: ./tmp)"
+    );
+
+    auto result = parse(argc, argv, cli);
+    if (!result) {
+        std::cout << make_man_page(cli, argv[0]);
+        exit(1);
+    }
+}
+
+static void create_console_logger() {
+    using namespace logging;
+
+    // Keep stdout clean for the results
+    logger *lg = create_logger("", L_WARN);
+    lg->add_writer(std::make_shared<console_writer>());
+    attach_logger(lg);
+}
+
+// Genome assembled from a pool of repeated blocks with sparse substitutions,
+// so the resulting graph has plenty of branching
+static std::string SyntheticGenome(size_t length, std::mt19937_64 &rnd) {
+    const size_t block_size = 300, num_blocks = 64;
+    std::uniform_int_distribution<int> nucl_dist(0, 3);
+
+    std::vector<std::string> blocks(num_blocks);
+    for (auto &block : blocks)
+        for (size_t i = 0; i < block_size; ++i)
+            block += nucl(char(nucl_dist(rnd)));
+
+    std::string genome;
+    std::uniform_int_distribution<size_t> block(0, num_blocks - 1), unique(0, 3 * block_size);
+    while (genome.size() < length) {
+        std::string b = blocks[block(rnd)];
+        b[unique(rnd) % block_size] = nucl(char(nucl_dist(rnd)));
+        genome += b;
+        for (size_t i = unique(rnd); i > 0; --i)
+            genome += nucl(char(nucl_dist(rnd)));
+    }
+    genome.resize(length);
+
+    return genome;
+}
+
+static std::vector<io::SingleRead> TileReads(const std::string &genome, size_t read_length, size_t step) {
+    std::vector<io::SingleRead> reads;
+    for (size_t pos = 0; pos + read_length <= genome.size(); pos += step) {
+        std::string seq = genome.substr(pos, read_length);
+        reads.emplace_back("", seq, std::string(seq.size(), 'I'));
+    }
+    return reads;
+}
+
+static io::ReadStreamList<io::SingleRead> ReadStreams(const std::vector<io::SingleRead> &reads) {
+    return io::ReadStreamList<io::SingleRead>(io::RCWrap<io::SingleRead>(io::VectorReadStream<io::SingleRead>(reads)));
+}
+
+static std::vector<RtSeq> GenomeKMers(const Sequence &genome, unsigned k) {
+    std::vector<RtSeq> kmers;
+    RtSeq kmer = genome.start<RtSeq>(k);
+    kmers.push_back(kmer);
+    for (size_t i = k; i < genome.size(); ++i) {
+        kmer <<= genome[i];
+        kmers.push_back(kmer);
+    }
+    return kmers;
+}
+
+static void SequenceBenchmarks(benchmark::Runner &runner, const Sequence &genome, unsigned k) {
+    runner.Run("rtseq/roll", genome.size() - k, [&]() {
+        RtSeq kmer = genome.start<RtSeq>(k);
+        for (size_t i = k; i < genome.size(); ++i)
+            kmer <<= genome[i];
+        benchmark::DoNotOptimize(kmer);
+    });
+
+    runner.Run("rtseq/roll_hash", genome.size() - k, [&]() {
+        RtSeq kmer = genome.start<RtSeq>(k);
+        size_t h = 0;
+        for (size_t i = k; i < genome.size(); ++i) {
+            kmer <<= genome[i];
+            h ^= kmer.GetHash();
+        }
+        benchmark::DoNotOptimize(h);
+    });
+
+    const size_t subseq_size = 1000, subseqs = 1000;
+    std::mt19937_64 rnd(genome.size());
+    std::uniform_int_distribution<size_t> pos_dist(0, genome.size() - subseq_size);
+    std::vector<size_t> pos(subseqs);
+    for (auto &p : pos)
+        p = pos_dist(rnd);
+
+    runner.Run("sequence/subseq", subseqs, [&]() {
+        for (size_t p : pos) {
+            Sequence s = genome.Subseq(p, p + subseq_size);
+            benchmark::DoNotOptimize(s);
+        }
+    });
+
+    runner.Run("sequence/subseq_rc", subseqs, [&]() {
+        for (size_t p : pos) {
+            Sequence s = !genome.Subseq(p, p + subseq_size);
+            benchmark::DoNotOptimize(s);
+        }
+    });
+
+    runner.Run("sequence/str", subseqs, [&]() {
+        for (size_t p : pos) {
+            std::string s = genome.Subseq(p, p + subseq_size).str();
+            benchmark::DoNotOptimize(s);
+        }
+    });
+}
+
+static void KMerIndexBenchmarks(benchmark::Runner &runner, const bcfg &cfg,
+                                const std::vector<io::SingleRead> &reads,
+                                const std::vector<RtSeq> &kmers) {
+    typedef utils::KMerIndex<utils::kmer_index_traits<RtSeq>> Index;
+    fs::TmpDir workdir = fs::tmp::make_temp_dir(cfg.tmpdir, "kmer_index");
+
+    if (runner.enabled("kmer_index/")) {
+        Index index;
+        auto streams = ReadStreams(reads);
+        utils::DeBruijnReadKMerSplitter<io::SingleRead, utils::StoringTypeFilter<utils::SimpleStoring>>
+                splitter(workdir, cfg.k, 0, streams);
+        utils::KMerDiskCounter<RtSeq> counter(workdir, splitter);
+        utils::KMerIndexBuilder<Index>(16, cfg.nthreads).BuildIndex(index, counter);
+
+        runner.Run("kmer_index/seq_idx", kmers.size(), [&]() {
+            size_t res = 0;
+            for (const RtSeq &kmer : kmers)
+                res += index.seq_idx(kmer);
+            benchmark::DoNotOptimize(res);
+        });
+    }
+
+    if (runner.enabled("extension_index/")) {
+        utils::DeBruijnExtensionIndex<> ext(cfg.k);
+        auto streams = ReadStreams(reads);
+        utils::DeBruijnExtensionIndexBuilder().BuildExtensionIndexFromStream(workdir, ext, streams);
+
+        typedef utils::DeBruijnExtensionIndex<>::KeyWithHash KeyWithHash;
+        std::vector<KeyWithHash> kwhs;
+        std::vector<char> nucls;
+        for (size_t i = 0; i + 1 < kmers.size(); ++i) {
+            kwhs.push_back(ext.ConstructKWH(kmers[i]));
+            kwhs.back().idx();
+            nucls.push_back(kmers[i + 1][cfg.k - 1]);
+        }
+
+        runner.Run("extension_index/construct_kwh", kmers.size(), [&]() {
+            size_t res = 0;
+            for (const RtSeq &kmer : kmers)
+                res += ext.ConstructKWH(kmer).idx();
+            benchmark::DoNotOptimize(res);
+        });
+
+        runner.Run("extension_index/mask_update", kwhs.size(), [&]() {
+            for (size_t i = 0; i < kwhs.size(); ++i) {
+                ext.DeleteOutgoing(kwhs[i], nucls[i]);
+                ext.AddOutgoing(kwhs[i], nucls[i]);
+            }
+        });
+
+        runner.Run("extension_index/check_outgoing", kwhs.size(), [&]() {
+            size_t res = 0;
+            for (size_t i = 0; i < kwhs.size(); ++i)
+                res += ext.CheckOutgoing(kwhs[i], nucls[i]);
+            benchmark::DoNotOptimize(res);
+        });
+    }
+}
+
+static void GraphBenchmarks(benchmark::Runner &runner, const bcfg &cfg,
+                            const std::vector<io::SingleRead> &reads) {
+    if (!runner.enabled("paired_index/") && !runner.enabled("dijkstra/") &&
+        !runner.enabled("sequence_mapper/"))
+        return;
+
+    fs::TmpDir workdir = fs::tmp::make_temp_dir(cfg.tmpdir, "graph");
+    ConjugateDeBruijnGraph g(cfg.k);
+    EdgeIndex<ConjugateDeBruijnGraph> index(g, workdir->dir());
+    index.Detach();
+    auto streams = ReadStreams(reads);
+    ConstructGraph(config::debruijn_config::construction(), workdir, streams, g, index);
+    index.Detach();
+
+    std::vector<EdgeId> edges;
+    for (EdgeId e : g.edges())
+        edges.push_back(e);
+    std::vector<VertexId> vertices;
+    for (VertexId v : g.vertices())
+        vertices.push_back(v);
+    std::mt19937_64 rnd(cfg.seed);
+
+    if (runner.enabled("sequence_mapper/")) {
+        // Sparse substitutions break the threading along the graph, so the index is queried
+        std::uniform_int_distribution<size_t> error_dist(0, 99);
+        std::uniform_int_distribution<int> nucl_dist(0, 3);
+        std::vector<Sequence> mapped;
+        for (const auto &read : reads) {
+            std::string seq = read.GetSequenceString();
+            for (char &c : seq)
+                if (error_dist(rnd) == 0)
+                    c = nucl(char(nucl_dist(rnd)));
+            mapped.emplace_back(seq);
+        }
+
+        index.Attach();
+        KmerMapper<ConjugateDeBruijnGraph> kmer_mapper(g);
+        BasicSequenceMapper<ConjugateDeBruijnGraph, EdgeIndex<ConjugateDeBruijnGraph>> mapper(g, index, kmer_mapper);
+        runner.Run("sequence_mapper/map_reads", mapped.size(), [&]() {
+            size_t res = 0;
+            for (const Sequence &s : mapped)
+                res += mapper.MapSequence(s).size();
+            benchmark::DoNotOptimize(res);
+        });
+        index.Detach();
+    }
+
+    typedef omnigraph::de::UnclusteredPairedInfoIndexT<ConjugateDeBruijnGraph> PairedIndex;
+    const size_t points = 100000;
+    std::uniform_int_distribution<size_t> edge_dist(0, edges.size() - 1);
+    std::uniform_int_distribution<int> dist_dist(0, 1000);
+    std::vector<std::pair<EdgeId, EdgeId>> pairs;
+    std::vector<omnigraph::de::RawPoint> pair_points;
+    for (size_t i = 0; i < points; ++i) {
+        pairs.emplace_back(edges[edge_dist(rnd)], edges[edge_dist(rnd)]);
+        pair_points.emplace_back(dist_dist(rnd), 1);
+    }
+
+    runner.Run("paired_index/insert", points, [&]() {
+        PairedIndex pi(g);
+        for (size_t i = 0; i < points; ++i)
+            pi.Add(pairs[i].first, pairs[i].second, pair_points[i]);
+        benchmark::DoNotOptimize(pi.size());
+    });
+
+    PairedIndex pi(g);
+    for (size_t i = 0; i < points; ++i)
+        pi.Add(pairs[i].first, pairs[i].second, pair_points[i]);
+
+    runner.Run("paired_index/lookup", points, [&]() {
+        size_t res = 0;
+        for (const auto &p : pairs)
+            res += pi.Get(p.first, p.second).size();
+        benchmark::DoNotOptimize(res);
+    });
+
+    const size_t starts = std::min(vertices.size(), size_t(256));
+    for (size_t bound : { 1000, 10000 }) {
+        runner.Run("dijkstra/bounded_" + std::to_string(bound), starts, [&]() {
+            auto dijkstra = omnigraph::DijkstraHelper<ConjugateDeBruijnGraph>::CreateBoundedDijkstra(g, bound);
+            size_t res = 0;
+            for (size_t i = 0; i < starts; ++i) {
+                dijkstra.Run(vertices[i]);
+                res += dijkstra.ReachedVertices().size();
+            }
+            benchmark::DoNotOptimize(res);
+        });
+    }
+}
+
+static void DSUBenchmarks(benchmark::Runner &runner, const bcfg &cfg) {
+    const size_t size = 1 << 20, unions = size / 2;
+    std::mt19937_64 rnd(cfg.seed);
+    std::uniform_int_distribution<size_t> dist(0, size - 1);
+    std::vector<std::pair<size_t, size_t>> pairs(unions);
+    for (auto &p : pairs)
+        p = { dist(rnd), dist(rnd) };
+
+    runner.Run("concurrent_dsu/unite", unions, [&]() {
+        dsu::ConcurrentDSU dsu(size);
+#       pragma omp parallel for num_threads(cfg.nthreads)
+        for (size_t i = 0; i < unions; ++i)
+            dsu.unite(pairs[i].first, pairs[i].second);
+        benchmark::DoNotOptimize(dsu.num_sets());
+    });
+
+    dsu::ConcurrentDSU dsu(size);
+    for (const auto &p : pairs)
+        dsu.unite(p.first, p.second);
+
+    runner.Run("concurrent_dsu/find", size, [&]() {
+        size_t res = 0;
+#       pragma omp parallel for num_threads(cfg.nthreads) reduction(+:res)
+        for (size_t i = 0; i < size; ++i)
+            res += dsu.find_set(i);
+        benchmark::DoNotOptimize(res);
+    });
+}
+
+int main(int argc, char **argv) {
+    bcfg cfg;
+    process_cmdline(argc, argv, cfg);
+
+    create_console_logger();
+
+    cfg.nthreads = std::max(1u, std::min(cfg.nthreads, (unsigned) omp_get_max_threads()));
+    omp_set_num_threads((int) cfg.nthreads);
+    if (cfg.tmpdir.empty())
+        cfg.tmpdir = "tmp";
+    fs::make_dirs(cfg.tmpdir);
+
+    std::mt19937_64 rnd(cfg.seed);
+    std::string genome_str = SyntheticGenome(cfg.genome_size, rnd);
+    Sequence genome(genome_str);
+    std::vector<io::SingleRead> reads = TileReads(genome_str, 150, 50);
+    std::vector<RtSeq> kmers = GenomeKMers(genome, cfg.k);
+
+    benchmark::Runner runner(cfg.filter, cfg.min_time);
+    SequenceBenchmarks(runner, genome, cfg.k);
+    KMerIndexBenchmarks(runner, cfg, reads, kmers);
+    GraphBenchmarks(runner, cfg, reads);
+    DSUBenchmarks(runner, cfg);
+
+    std::vector<std::pair<std::string, std::string>> context = {
+        { "refspec", version::refspec() },
+        { "gitrev", version::gitrev() },
+        { "k", std::to_string(cfg.k) },
+        { "genome_size", std::to_string(cfg.genome_size) },
+        { "threads", std::to_string(cfg.nthreads) },
+        { "seed", std::to_string(cfg.seed) }
+    };
+
+    if (cfg.outfile.empty()) {
+        runner.WriteJSON(std::cout, context);
+    } else {
+        std::ofstream os(cfg.outfile);
+        runner.WriteJSON(os, context);
+    }
+
+    return 0;
+}
@@ -9,7 +9,10 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include "graphio.hpp"
 #include "test_utils.hpp"
+#include "assembly_graph/dijkstra/dijkstra_helper.hpp"
+#include "assembly_graph/dijkstra/bidirectional_dijkstra.hpp"
 
 namespace debruijn_graph {
 
@@ -58,6 +61,95 @@ BOOST_AUTO_TEST_CASE( OneEdgeGraphTest ) {
             g.EdgeNucls(g.conjugate(data.second[0])));
 }
 
+BOOST_AUTO_TEST_CASE( NuclArenaGraphTest ) {
+    Graph g(11);
+    g.EnableNuclArena();
+    VertexId v1 = g.AddVertex(), v2 = g.AddVertex(), v3 = g.AddVertex();
+    Sequence s1("ACGTTGCAACGTAGGTCCA"), s2("GTCCATTTGACGTACCAGTGCATTGCAAAC");
+    EdgeId e1 = g.AddEdge(v1, v2, s1);
+    EdgeId e2 = g.AddEdge(v2, v3, s2.Subseq(0, 21));
+    BOOST_CHECK_EQUAL(s1, g.EdgeNucls(e1));
+    BOOST_CHECK_EQUAL(!s1, g.EdgeNucls(g.conjugate(e1)));
+    BOOST_CHECK_EQUAL(s2.Subseq(0, 21), g.EdgeNucls(e2));
+    BOOST_CHECK_EQUAL(s1.str(), g.EdgeNuclsView(e1).str());
+    BOOST_CHECK_EQUAL((!s2.Subseq(0, 21)).str(), g.EdgeNuclsView(g.conjugate(e2)).str());
+    BOOST_CHECK_EQUAL((!s2.Subseq(0, 21)).Subseq(3), Sequence(g.EdgeNuclsView(g.conjugate(e2)).Subseq(3)));
+    BOOST_CHECK(g.EdgeNuclsView(e2).contains(s2.Subseq(2, 13), 2));
+
+    g.DeleteEdge(e1);
+    g.CompactNucls();
+    BOOST_CHECK_EQUAL(s2.Subseq(0, 21), g.EdgeNucls(e2));
+    BOOST_CHECK_EQUAL(!s2.Subseq(0, 21), g.EdgeNucls(g.conjugate(e2)));
+}
+
+BOOST_AUTO_TEST_CASE( CompactLayoutTest ) {
+    Graph g(55);
+    graphio::ScanBasicGraph("./src/test/debruijn/graph_fragments/ecoli_400k/distance_estimation", g);
+    omnigraph::CompactGraphLayout<Graph> layout(g);
+    BOOST_CHECK(layout.stale());
+    layout.Refresh();
+    BOOST_CHECK(!layout.stale());
+
+    for (VertexId v : g) {
+        BOOST_CHECK_EQUAL(g.conjugate(v), layout.conjugate(v));
+        BOOST_CHECK_EQUAL(g.OutgoingEdgeCount(v), layout.OutgoingEdgeCount(v));
+        BOOST_CHECK_EQUAL(g.IncomingEdgeCount(v), layout.IncomingEdgeCount(v));
+        BOOST_CHECK(std::equal(g.out_begin(v), g.out_end(v), layout.OutgoingEdges(v).begin()));
+        BOOST_CHECK(std::equal(g.in_begin(v), g.in_end(v), layout.IncomingEdges(v).begin()));
+    }
+    for (EdgeId e : g.edges()) {
+        BOOST_CHECK_EQUAL(g.EdgeStart(e), layout.EdgeStart(e));
+        BOOST_CHECK_EQUAL(g.EdgeEnd(e), layout.EdgeEnd(e));
+        BOOST_CHECK_EQUAL(g.conjugate(e), layout.conjugate(e));
+        BOOST_CHECK_EQUAL(g.length(e), layout.length(e));
+    }
+
+    typedef omnigraph::DijkstraHelper<Graph> DH;
+    size_t cnt = 0;
+    for (VertexId v : g) {
+        if (cnt++ == 50)
+            break;
+        auto dijkstra = DH::CreateBoundedDijkstra(g, 3000);
+        auto compact_dijkstra = DH::CreateCompactBoundedDijkstra(g, layout, 3000);
+        dijkstra.Run(v);
+        compact_dijkstra.Run(v);
+        auto reached = dijkstra.ReachedVertices();
+        BOOST_CHECK_EQUAL(reached.size(), compact_dijkstra.ReachedVertices().size());
+        for (VertexId u : reached)
+            BOOST_CHECK_EQUAL(dijkstra.GetDistance(u), compact_dijkstra.GetDistance(u));
+    }
+
+    g.DeleteEdge(*g.e_begin());
+    BOOST_CHECK(layout.stale());
+}
+
+BOOST_AUTO_TEST_CASE( BidirectionalDijkstraTest ) {
+    Graph g(55);
+    graphio::ScanBasicGraph("./src/test/debruijn/graph_fragments/ecoli_400k/distance_estimation", g);
+    omnigraph::CompactGraphLayout<Graph> layout(g);
+    layout.Refresh();
+
+    typedef omnigraph::DijkstraHelper<Graph> DH;
+    const size_t bound = 3000;
+    omnigraph::BidirectionalDijkstra<Graph> bidirectional(g, bound);
+    omnigraph::BidirectionalDijkstra<Graph, omnigraph::CompactGraphLayout<Graph>> compact_bidirectional(layout, bound);
+    omnigraph::DijkstraWorkspace<Graph> workspace;
+
+    std::vector<VertexId> vertices(g.begin(), g.end());
+    size_t cnt = 0;
+    for (VertexId v : vertices) {
+        if (cnt++ == 20)
+            break;
+        auto dijkstra = DH::CreateBoundedDijkstra(g, bound);
+        dijkstra.Run(v);
+        for (VertexId u : vertices) {
+            size_t expected = dijkstra.DistanceCounted(u) ? dijkstra.GetDistance(u) : size_t(-1);
+            BOOST_CHECK_EQUAL(expected, bidirectional.Distance(v, u, workspace));
+            BOOST_CHECK_EQUAL(expected, compact_bidirectional.Distance(v, u, workspace));
+        }
+    }
+}
+
 /*void EdgeMethodsSimpleTest() {
     Graph g(11);
     pair<vector<VertexId> , vector<EdgeId> > data = createGraph(g, 2);
@@ -227,6 +319,75 @@ BOOST_AUTO_TEST_CASE( TestSelfRCEdgeMerge ) {
     BOOST_CHECK_EQUAL(Sequence("AACGCTATTCACGTGAATAGCGTT"), g.EdgeNucls(g.GetUniqueOutgoingEdge(v1)));
 }
 
+class EventRecorder : public omnigraph::GraphActionHandler<Graph> {
+    bool deferrable_;
+
+    void Record(const std::string &event, EdgeId e) {
+        events.push_back(event + " " + std::to_string(e.int_id()) + " " + g().EdgeNucls(e).str());
+    }
+
+public:
+    std::vector<std::string> events;
+
+    EventRecorder(const Graph &g, bool deferrable)
+            : omnigraph::GraphActionHandler<Graph>(g, "EventRecorder"), deferrable_(deferrable) {}
+
+    void HandleAdd(EdgeId e) override { Record("add", e); }
+    void HandleDelete(EdgeId e) override { Record("delete", e); }
+    void HandleDelete(VertexId v) override { events.push_back("delete " + std::to_string(v.int_id())); }
+
+    void HandleMerge(const std::vector<EdgeId> &old_edges, EdgeId new_edge) override {
+        for (EdgeId e : old_edges)
+            Record("merge", e);
+        Record("merged", new_edge);
+    }
+
+    bool IsDeferrable() const override { return deferrable_; }
+};
+
+BOOST_AUTO_TEST_CASE( EventBatchTest ) {
+    Graph g(5);
+    VertexId v1 = g.AddVertex(), v2 = g.AddVertex(), v3 = g.AddVertex(), v4 = g.AddVertex();
+    g.AddEdge(v1, v2, Sequence("AACGCTA"));
+    g.AddEdge(v2, v3, Sequence("CGCTATTCA"));
+    EdgeId tip = g.AddEdge(v2, v4, Sequence("CGCTACCG"));
+
+    EventRecorder immediate(g, false), deferred(g, true);
+    {
+        omnigraph::EventBatch<Graph> batch(g);
+        g.DeleteEdge(tip);
+        g.DeleteVertex(v4);
+        g.CompressVertex(v2);
+        BOOST_CHECK(!immediate.events.empty());
+        BOOST_CHECK(deferred.events.empty());
+        BOOST_CHECK_EQUAL(2u, g.e_size());
+        BOOST_CHECK_EQUAL(4u, g.size());
+    }
+    BOOST_CHECK(immediate.events == deferred.events);
+    BOOST_CHECK_EQUAL(2u, g.e_size());
+    BOOST_CHECK(!g.contains(tip));
+    BOOST_CHECK_EQUAL(Sequence("AACGCTATTCA"), g.EdgeNucls(g.GetUniqueOutgoingEdge(v1)));
+}
+
+BOOST_AUTO_TEST_CASE( EventBatchPartialCommit ) {
+    Graph g(5);
+    VertexId v1 = g.AddVertex(), v2 = g.AddVertex(), v3 = g.AddVertex();
+    EdgeId e1 = g.AddEdge(v1, v2, Sequence("AACGCTA"));
+    EdgeId e2 = g.AddEdge(v1, v3, Sequence("AACGTTC"));
+
+    EventRecorder deferred(g, true);
+    omnigraph::EventBatch<Graph> batch(g);
+    g.DeleteEdge(e1);
+    batch.CommitIfExceeds(2);
+    BOOST_CHECK(deferred.events.empty());
+    batch.CommitIfExceeds(1);
+    size_t committed = deferred.events.size();
+    BOOST_CHECK(committed > 0);
+    BOOST_CHECK(!g.contains(e1));
+    g.DeleteEdge(e2);
+    BOOST_CHECK_EQUAL(committed, deferred.events.size());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
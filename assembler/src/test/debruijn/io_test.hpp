@@ -11,8 +11,12 @@
 #include "random_graph.hpp"
 #include "assembly_graph/handlers/id_track_handler.hpp"
 #include "io/binary/graph.hpp"
+#include "io/binary/edge_index.hpp"
 #include "io/binary/kmer_mapper.hpp"
 #include "io/binary/paired_index.hpp"
+#include "io/reads/fasta_fastq_parser.hpp"
+
+#include <zlib.h>
 
 #include <boost/test/unit_test.hpp>
 
@@ -115,5 +119,122 @@ BOOST_AUTO_TEST_CASE(TestKmerMapperIO) {
     CompareContainers(kmer_mapper, new_mapper);
 }
 
+BOOST_AUTO_TEST_CASE(TestEdgeIndexIO) {
+    typedef io::VectorReadStream<io::SingleRead> RawStream;
+    std::vector<std::string> reads = { "CGAAACCAC", "CGAAAACAC", "AACCACACC", "AAACACACC" };
+    conj_graph_pack gp(5, "tmp", 0);
+    auto workdir = fs::tmp::make_temp_dir(gp.workdir, "tests");
+    io::ReadStreamList<io::SingleRead> streams(io::RCWrap<io::SingleRead>(RawStream(MakeReads(reads))));
+    ConstructGraph(config::debruijn_config::construction(), workdir, streams, gp.g, gp.index);
+
+    Save(file_name, gp.index);
+
+    EdgeIndex<Graph> new_index(gp.g, gp.workdir);
+    new_index.Detach();
+    BOOST_CHECK(Load(file_name, new_index));
+    new_index.Attach();
+    for (EdgeId e : gp.g.edges()) {
+        RtSeq kmer = gp.g.EdgeNucls(e).start<RtSeq>(gp.g.k() + 1);
+        BOOST_CHECK(new_index.contains(kmer));
+        BOOST_CHECK(new_index.get(kmer).first == e);
+    }
+    new_index.Detach();
+
+    //Index saved for another graph should not be loaded
+    conj_graph_pack other_gp(5, "tmp", 0);
+    io::ReadStreamList<io::SingleRead> other_streams(io::RCWrap<io::SingleRead>(RawStream(MakeReads({ "ACGTTGCAAC" }))));
+    ConstructGraph(config::debruijn_config::construction(), workdir, other_streams, other_gp.g, other_gp.index);
+    other_gp.index.Detach();
+    BOOST_CHECK(!Load(file_name, other_gp.index));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_FIXTURE_TEST_SUITE(reads_parser_tests, fs::TmpFolderFixture)
+
+static void WriteGzip(const std::string &filename, const std::string &content, size_t member_cnt) {
+    for (size_t i = 0; i < member_cnt; ++i) {
+        // Every append starts a new gzip member
+        gzFile f = gzopen(filename.c_str(), i ? "ab" : "wb");
+        size_t from = content.size() * i / member_cnt, to = content.size() * (i + 1) / member_cnt;
+        gzwrite(f, content.data() + from, unsigned(to - from));
+        gzclose(f);
+    }
+}
+
+static void WriteBgzf(const std::string &filename, const std::string &content, size_t block_size) {
+    std::ofstream out(filename, std::ios::binary);
+    for (size_t from = 0; from < content.size(); from += block_size) {
+        size_t size = std::min(block_size, content.size() - from);
+        std::vector<char> packed(compressBound(uLong(size)));
+        z_stream zs = {};
+        deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+        zs.next_in = (Bytef*) (content.data() + from);
+        zs.avail_in = uInt(size);
+        zs.next_out = (Bytef*) packed.data();
+        zs.avail_out = uInt(packed.size());
+        BOOST_REQUIRE_EQUAL(deflate(&zs, Z_FINISH), Z_STREAM_END);
+        packed.resize(zs.total_out);
+        deflateEnd(&zs);
+
+        auto put16 = [&](size_t v) { out.put(char(v & 0xff)); out.put(char((v >> 8) & 0xff)); };
+        auto put32 = [&](size_t v) { put16(v & 0xffff); put16(v >> 16); };
+        const char header[] = {'\x1f', '\x8b', 8, 4, 0, 0, 0, 0, 0, '\xff', 6, 0, 'B', 'C', 2, 0};
+        out.write(header, sizeof(header));
+        put16(sizeof(header) + 2 + packed.size() + 8 - 1);
+        out.write(packed.data(), packed.size());
+        put32(crc32(0, (const Bytef*) (content.data() + from), uInt(size)));
+        put32(size);
+    }
+}
+
+static void CheckParser(const std::string &filename, const std::vector<io::SingleRead> &expected) {
+    io::FastaFastqParser parser(filename);
+    BOOST_REQUIRE(parser.is_open());
+    size_t i = 0;
+    for (; !parser.eof() && i < expected.size(); ++i) {
+        io::SingleRead read;
+        parser >> read;
+        BOOST_CHECK_EQUAL(read.name(), expected[i].name());
+        BOOST_CHECK_EQUAL(read.GetSequenceString(), expected[i].GetSequenceString());
+        BOOST_CHECK_EQUAL(read.GetQualityString(), expected[i].GetQualityString());
+    }
+    BOOST_CHECK_EQUAL(i, expected.size());
+    BOOST_CHECK(parser.eof());
+}
+
+BOOST_AUTO_TEST_CASE(FastaFastqParserPlain) {
+    std::ofstream("tmp/reads.fasta") << "garbage\n>r1 comment\nACGTacgt\nTTGCA\n\n>r2\nAC\r\nGT\r\n>r3\n>r4\nNNA";
+    CheckParser("tmp/reads.fasta", { io::SingleRead("r1 comment", "ACGTACGTTTGCA"), io::SingleRead("r2", "ACGT"),
+                                     io::SingleRead("r3", ""), io::SingleRead("r4", "NNA") });
+
+    std::ofstream("tmp/reads.fastq") << "@r1\nACGT\n+\nIIII\n@r2\nAC\r\ngt\r\n+r2\r\n@I\r\nII\r\n@r3\nA\n+\n#";
+    CheckParser("tmp/reads.fastq", { io::SingleRead("r1", "ACGT", "IIII", io::PhredOffset),
+                                     io::SingleRead("r2", "ACGT", "@III", io::PhredOffset),
+                                     io::SingleRead("r3", "A", "#", io::PhredOffset) });
+
+    BOOST_CHECK(!io::FastaFastqParser("tmp/no_such_file.fastq").is_open());
+}
+
+BOOST_AUTO_TEST_CASE(FastaFastqParserCompressed) {
+    std::string fastq;
+    std::vector<io::SingleRead> reads;
+    for (size_t i = 0; i < 20000; ++i) {
+        std::string name = "read_" + std::to_string(i);
+        std::string seq = RandomSequence(50 + i % 100).str();
+        std::string qual(seq.size(), char('#' + i % 40));
+        fastq += "@" + name + "\n" + seq + "\n+\n" + qual + "\n";
+        reads.emplace_back(name, seq, qual, io::PhredOffset);
+    }
+    std::ofstream("tmp/reads.fastq") << fastq;
+    CheckParser("tmp/reads.fastq", reads);
+
+    WriteGzip("tmp/reads.fastq.gz", fastq, 3);
+    CheckParser("tmp/reads.fastq.gz", reads);
+
+    WriteBgzf("tmp/reads_bgzf.fastq.gz", fastq, 65280);
+    CheckParser("tmp/reads_bgzf.fastq.gz", reads);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }
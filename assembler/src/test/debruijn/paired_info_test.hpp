@@ -8,6 +8,10 @@
 
 #include <boost/test/unit_test.hpp>
 #include "paired_info/paired_info_helpers.hpp"
+#include "paired_info/concurrent_pair_info_buffer.hpp"
+#include "paired_info/frozen_paired_index.hpp"
+#include "paired_info/distance_estimation.hpp"
+#include "graphio.hpp"
 #include "random_graph.hpp"
 #include "io/binary/paired_index.hpp"
 
@@ -459,6 +463,145 @@ BOOST_AUTO_TEST_CASE(PairedInfoRandomSymmetry) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(PairedInfoThreadLocalBuffer) {
+    Graph graph(55);
+    debruijn_graph::RandomGraph<Graph>(graph, /*max_size*/100).Generate(/*iterations*/1000);
+    std::vector<Graph::EdgeId> edges;
+    for (auto e : graph.edges())
+        edges.push_back(e);
+
+    // Enough points for the thread logs to be compacted at least once
+    const size_t nthreads = 2, npoints = 2500000;
+    auto point = [&](size_t i, Graph::EdgeId &e1, Graph::EdgeId &e2) {
+        size_t h = i * 2654435761u;
+        e1 = edges[h % edges.size()];
+        e2 = edges[(h >> 16) % edges.size()];
+        return RawPoint(DEDistance(int(i % 50)), DEWeight(1 + i % 3));
+    };
+
+    TestIndex expected(graph);
+    for (size_t i = 0; i < npoints; ++i) {
+        Graph::EdgeId e1, e2;
+        RawPoint p = point(i, e1, e2);
+        expected.Add(e1, e2, p);
+    }
+
+    ThreadLocalPairedInfoBuffer<Graph> buffer(graph, nthreads);
+#   pragma omp parallel for num_threads(nthreads)
+    for (size_t t = 0; t < nthreads; ++t) {
+        for (size_t i = t; i < npoints; i += nthreads) {
+            Graph::EdgeId e1, e2;
+            RawPoint p = point(i, e1, e2);
+            buffer.Add(t, e1, e2, p);
+        }
+    }
+
+    TestIndex pi(graph);
+    pi.MoveAssign(buffer);
+    BOOST_CHECK_EQUAL(pi.size(), expected.size());
+    for (auto it = pair_begin(expected); it != pair_end(expected); ++it) {
+        auto info = *it;
+        auto actual = pi.Get(it.first(), it.second());
+        BOOST_REQUIRE_EQUAL(info.size(), actual.size());
+        for (auto i = info.begin(), j = actual.begin(); i != info.end(); ++i, ++j) {
+            BOOST_CHECK_EQUAL(*i, *j);
+            BOOST_CHECK_EQUAL(float((*i).weight), float((*j).weight));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(PairedInfoFrozenIndex) {
+    using ClIndex = PairedInfoIndexT<Graph>;
+    Graph graph(55);
+    debruijn_graph::RandomGraph<Graph>(graph, /*max_size*/100).Generate(/*iterations*/1000);
+
+    std::vector<Graph::EdgeId> edges;
+    for (auto e : graph.edges())
+        edges.push_back(e);
+
+    ClIndex pi(graph);
+    srand(100);
+    for (size_t i = 0; i < 2000; ++i)
+        pi.Add(edges[rand() % edges.size()], edges[rand() % edges.size()],
+               Point(DEDistance(rand() % 100), DEWeight(1 + rand() % 5), DEVariance(rand() % 3)));
+    FrozenPairedInfoIndexT<Graph> frozen(pi);
+
+    BOOST_CHECK_EQUAL(frozen.size(), pi.size());
+    for (auto e1 : graph.edges()) {
+        BOOST_CHECK_EQUAL(frozen.contains(e1), pi.contains(e1));
+
+        std::vector<std::pair<Graph::EdgeId, std::vector<Point>>> expected, actual;
+        for (auto i : pi.Get(e1))
+            expected.emplace_back(i.first, std::vector<Point>(i.second.begin(), i.second.end()));
+        for (auto i : frozen.Get(e1))
+            actual.emplace_back(i.first, std::vector<Point>(i.second.begin(), i.second.end()));
+        BOOST_CHECK(expected == actual);
+
+        std::vector<Graph::EdgeId> expected_half, actual_half;
+        for (auto i : pi.GetHalf(e1))
+            expected_half.push_back(i.first);
+        for (auto i : frozen.GetHalf(e1))
+            actual_half.push_back(i.first);
+        BOOST_CHECK(expected_half == actual_half);
+
+        for (auto e2 : graph.edges()) {
+            BOOST_CHECK_EQUAL(frozen.contains(e1, e2), pi.contains(e1, e2));
+            auto hist = frozen.Get(e1, e2);
+            auto expected_hist = pi.Get(e1, e2);
+            BOOST_REQUIRE_EQUAL(hist.size(), expected_hist.size());
+            auto j = expected_hist.begin();
+            for (auto p : hist) {
+                BOOST_CHECK_EQUAL(p, *j);
+                BOOST_CHECK_EQUAL(float(p.weight), float((*j).weight));
+                ++j;
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GraphDistanceFinderCache) {
+    Graph graph(55);
+    debruijn_graph::graphio::ScanBasicGraph("./src/test/debruijn/graph_fragments/ecoli_400k/distance_estimation", graph);
+
+    GraphDistanceFinder finder(graph, 1000, 100, 50);
+    GraphDistanceFinder cached_finder(graph, 1000, 100, 50, /*cache_memory_limit*/ 1 << 20);
+
+    std::map<Graph::EdgeId, std::vector<size_t>> expected, actual;
+    for (auto e : graph.edges())
+        expected[e], actual[e];
+    size_t found = 0;
+    //Second pass takes the lengths from the cache
+    for (size_t pass = 0; pass < 2; ++pass) {
+        for (auto e1 : graph.edges()) {
+            finder.FillGraphDistancesLengths(e1, expected);
+            cached_finder.FillGraphDistancesLengths(e1, actual);
+            BOOST_CHECK(expected == actual);
+            for (const auto &entry : actual)
+                found += entry.second.size();
+        }
+    }
+    BOOST_CHECK(found > 0);
+}
+
+BOOST_AUTO_TEST_CASE(GraphDistanceFinderCompactLayout) {
+    Graph graph(55);
+    debruijn_graph::graphio::ScanBasicGraph("./src/test/debruijn/graph_fragments/ecoli_400k/distance_estimation", graph);
+    CompactGraphLayout<Graph> layout(graph);
+    layout.Refresh();
+
+    GraphDistanceFinder finder(graph, 1000, 100, 50);
+    GraphDistanceFinder compact_finder(graph, 1000, 100, 50, /*cache_memory_limit*/ 0, &layout);
+
+    std::map<Graph::EdgeId, std::vector<size_t>> expected, actual;
+    for (auto e : graph.edges())
+        expected[e], actual[e];
+    for (auto e1 : graph.edges()) {
+        finder.FillGraphDistancesLengths(e1, expected);
+        compact_finder.FillGraphDistancesLengths(e1, actual);
+        BOOST_CHECK(expected == actual);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace de
@@ -20,6 +20,7 @@
 #include "test_utils.hpp"
 #include "modules/path_extend/path_visualizer.hpp"
 #include "modules/path_extend/pe_utils.hpp"
+#include "modules/path_extend/path_extender.hpp"
 namespace path_extend {
 
 BOOST_FIXTURE_TEST_SUITE(path_extend_basic, fs::TmpFolderFixture)
@@ -765,6 +766,50 @@ BOOST_AUTO_TEST_CASE( BidirectionalPathLoopDetector ) {
 }
 
 
+static std::vector<std::vector<EdgeId>> GrowSingleEdgeSeeds(const conj_graph_pack &gp, bool parallel) {
+    auto make_extenders = [&gp](const GraphCoverageMap &cov_map, UsedUniqueStorage &used) {
+        return CompositeExtender::ExtendersT{std::make_shared<SimpleExtender>(
+                gp, cov_map, used, std::make_shared<TrivialExtensionChooser>(gp.g), 300, false, false)};
+    };
+
+    PathContainer seeds;
+    for (auto it = gp.g.ConstEdgeBegin(true); !it.IsEnd(); ++it)
+        seeds.AddPair(new BidirectionalPath(gp.g, *it), new BidirectionalPath(gp.g, gp.g.conjugate(*it)));
+
+    ScaffoldingUniqueEdgeStorage unique;
+    UsedUniqueStorage used(unique, gp.g);
+    GraphCoverageMap cov_map(gp.g);
+    CompositeExtender extender(gp.g, cov_map, used, make_extenders(cov_map, used),
+                               parallel ? CompositeExtender::ExtendersFactory(make_extenders) : nullptr);
+    PathContainer result;
+    extender.GrowAll(seeds, result);
+
+    std::vector<std::vector<EdgeId>> answer;
+    uint64_t prev_id = 0;
+    for (auto iter = result.begin(); iter != result.end(); ++iter) {
+        //paths are expected to be numbered in the order of their seeds
+        BOOST_CHECK(answer.empty() || iter.get()->GetId() > prev_id);
+        BOOST_CHECK(iter.getConjugate()->GetId() > iter.get()->GetId());
+        prev_id = iter.getConjugate()->GetId();
+        answer.emplace_back(iter.get()->begin(), iter.get()->end());
+        answer.emplace_back(iter.getConjugate()->begin(), iter.getConjugate()->end());
+    }
+    return answer;
+}
+
+BOOST_AUTO_TEST_CASE( ParallelGrowthMatchesSerial ) {
+    conj_graph_pack gp(55, "tmp", 0);
+    graphio::ScanGraphPack("./src/test/debruijn/graph_fragments/ecoli_400k/distance_estimation", gp);
+
+    auto serial = GrowSingleEdgeSeeds(gp, false);
+    BOOST_CHECK(!serial.empty());
+    //parallel growth is only used with several threads
+    int nthreads = omp_get_max_threads();
+    omp_set_num_threads(4);
+    BOOST_CHECK(serial == GrowSingleEdgeSeeds(gp, true));
+    omp_set_num_threads(nthreads);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -14,6 +14,7 @@
 #include "stages/simplification_pipeline/single_cell_simplification.hpp"
 #include "stages/simplification_pipeline/rna_simplification.hpp"
 #include <boost/test/unit_test.hpp>
+#include <random>
 //#include "repeat_resolving_routine.hpp"
 
 namespace debruijn_graph {
@@ -163,6 +164,61 @@ BOOST_AUTO_TEST_CASE( SimpleBulgeRemovalTest ) {
     BOOST_CHECK_EQUAL(g.size(), 4u);
 }
 
+//chain of segments of random genome, each accompanied by up to 3 low covered variants
+void GenerateBulgeChain(Graph &g, size_t genome_length, unsigned seed) {
+    std::mt19937 rnd(seed);
+    const std::string nucls = "ACGT";
+    std::string genome;
+    for (size_t i = 0; i < genome_length; ++i)
+        genome += nucls[rnd() % 4];
+
+    size_t k = g.k(), pos = 0;
+    VertexId prev = g.AddVertex();
+    while (pos + 300 + k < genome.size()) {
+        size_t len = 60 + rnd() % 120;
+        VertexId next = g.AddVertex();
+        std::string main = genome.substr(pos, len + k);
+        EdgeId e = g.AddEdge(prev, next, Sequence(main));
+        g.coverage_index().SetAvgCoverage(e, 30. + double(rnd() % 40));
+        size_t variant_cnt = rnd() % 4;
+        for (size_t i = 0; i < variant_cnt; ++i) {
+            std::string variant = main;
+            size_t p = k + rnd() % (len - k);
+            if (rnd() % 3 == 0)
+                variant.erase(p, 1 + rnd() % 3);
+            else
+                variant[p] = nucls[(nucls.find(variant[p]) + 1 + rnd() % 3) % 4];
+            EdgeId ve = g.AddEdge(prev, next, Sequence(variant));
+            g.coverage_index().SetAvgCoverage(ve, 1. + double(rnd() % 35));
+        }
+        prev = next;
+        pos += len;
+    }
+}
+
+std::multiset<std::string> EdgeSequences(const Graph &g) {
+    std::multiset<std::string> answer;
+    for (EdgeId e : g.edges())
+        answer.insert(g.EdgeNucls(e).str());
+    return answer;
+}
+
+BOOST_AUTO_TEST_CASE( ParallelBulgeRemovalTest ) {
+    Graph g1(55), g2(55);
+    GenerateBulgeChain(g1, 400000, 42);
+    GenerateBulgeChain(g2, 400000, 42);
+
+    auto br_config = standard_br_config();
+    //single buffer, large enough for the parallel processing
+    br_config.buff_cov_diff = 1000.;
+    debruijn::simplification::BRInstance(g1, br_config, standard_simplif_relevant_info(), trivial_false)->Run();
+    br_config.parallel = true;
+    debruijn::simplification::BRInstance(g2, br_config, standard_simplif_relevant_info(), trivial_false)->Run();
+
+    BOOST_CHECK_EQUAL(g1.e_size(), g2.e_size());
+    BOOST_CHECK(EdgeSequences(g1) == EdgeSequences(g2));
+}
+
 BOOST_AUTO_TEST_CASE( TipobulgeTest ) {
     Graph g(55);
     graphio::ScanBasicGraph("./src/test/debruijn/graph_fragments/tipobulge/tipobulge", g);
@@ -372,6 +428,24 @@ BOOST_AUTO_TEST_CASE( CompressorTest ) {
     BOOST_CHECK_EQUAL(gp.g.size(), graph_size);
 }
 
+BOOST_AUTO_TEST_CASE( BulkCompressorTest ) {
+    std::string path = "./src/test/debruijn/graph_fragments/compression/graph";
+    size_t graph_size = 12;
+    conj_graph_pack gp(55, "tmp", 0);
+    graphio::ScanGraphPack(path, gp);
+    CompressAllVertices(gp.g, /*chunk_cnt*/8);
+    BOOST_CHECK_EQUAL(gp.g.size(), graph_size);
+
+    Graph g1(55), g2(55);
+    GenerateBulgeChain(g1, 400000, 7);
+    GenerateBulgeChain(g2, 400000, 7);
+    CompressAllVertices(g1);
+    BOOST_CHECK(BulkCompressor<Graph>(g2).Run(/*chunk_cnt*/8) > 0);
+    CompressAllVertices(g2, /*chunk_cnt*/8);
+    BOOST_CHECK_EQUAL(g1.e_size(), g2.e_size());
+    BOOST_CHECK(EdgeSequences(g1) == EdgeSequences(g2));
+}
+
 #if 0
 BOOST_AUTO_TEST_CASE( ParallelCompressor1 ) {
     std::string path = "./src/test/debruijn/graph_fragments/compression/graph";